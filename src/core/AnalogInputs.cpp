@@ -24,9 +24,12 @@
 #include "eeprom.h"
 #include "atomic.h"
 #include "Balancer.h"
+#include "Units.h"
+#include "Profile.h"
 
 #define ANALOG_INPUTS_E_OUT_dt_FACTOR   50
 #define ANALOG_INPUTS_E_OUT_DIVIDER     100
+#define ANALOG_INPUTS_MAX_IOUT          (MAX_CHARGE_I > MAX_DISCHARGE_I ? MAX_CHARGE_I : MAX_DISCHARGE_I)
 
 #define ANALOG_INPUTS_ADC_MEASUREMENTS_COUNT (ANALOG_INPUTS_ADC_ROUND_MAX_COUNT*ANALOG_INPUTS_ADC_BURST_COUNT)
 
@@ -67,6 +70,17 @@ namespace AnalogInputs {
     ValueType real_[ALL_INPUTS];
     uint16_t stableCount_[ALL_INPUTS];
 
+    // Pout and Eout are mostly only displayed or logged,
+    // they are evaluated on the first read after a full measurement.
+    // Cout is read by Monitor::run on every loop, it stays eager.
+    // bit (name - LAZY_FIRST) set - value has to be recalculated
+    static const Name LAZY_FIRST = Pout;
+    static const Name LAZY_LAST  = Eout;
+    static const uint8_t LAZY_ALL = (1 << (Pout - LAZY_FIRST)) | (1 << (Eout - LAZY_FIRST));
+    uint8_t lazyDirty_;
+    //full measurement count at the last evaluation, the stable counters count measurements, not reads
+    uint16_t lazyCount_[LAZY_LAST - LAZY_FIRST + 1];
+
     uint16_t calculationCount_;
 
     uint16_t    i_deltaAvrCount_;
@@ -92,7 +106,7 @@ namespace AnalogInputs {
 
 
     ValueType getAvrADCValue(Name name)     { return avrAdc_[name];   }
-    ValueType getRealValue(Name name)       { return real_[name]; }
+    ValueType getRealValue(Name name);
     ValueType getADCValue(Name name)        { RETURN_ATOMIC(i_adc_[name]) }
     bool isPowerOn() { return on_; }
     uint16_t getFullMeasurementCount()      { return calculationCount_; }
@@ -100,7 +114,7 @@ namespace AnalogInputs {
     ValueType getDeltaCount()               { return deltaCount_;}
     void enableDeltaVoutMax(bool enable)    { enable_deltaVoutMax_ = enable; }
 
-    uint16_t getStableCount(Name name)      { return stableCount_[name]; };
+    uint16_t getStableCount(Name name)      { getRealValue(name); return stableCount_[name]; };
     bool isStable(Name name)                { return getStableCount(name) >= STABLE_MIN_VALUE; };
     void setReal(Name name, ValueType real);
     void setRealBasedOnAvr(AnalogInputs::Name name);
@@ -108,6 +122,7 @@ namespace AnalogInputs {
     void finalizeDeltaMeasurement();
     void finalizeFullMeasurement();
     void finalizeFullVirtualMeasurement();
+    void finalizeLazyVirtualMeasurement(Name name);
 
     uint16_t getConnectedBalancePortCells();
     void saveBalancePortState()             { balancePortStateSaved_ = true; }
@@ -261,6 +276,10 @@ void AnalogInputs::resetAccumulatedMeasurements()
     setReal(Cout, 0);
     setReal(deltaVout, 0);
     setReal(deltaTextern, 0);
+    lazyDirty_ = LAZY_ALL;
+    for(uint8_t i = 0; i < sizeOfArray(lazyCount_); i++) {
+        lazyCount_[i] = calculationCount_;
+    }
 }
 
 void AnalogInputs::reset()
@@ -385,8 +404,8 @@ static inline uint32_t toHoursBasis(uint32_t accumulator) {
 
 AnalogInputs::ValueType AnalogInputs::getCharge()
 {
-    //check units
-    STATIC_ASSERT(ANALOG_AMP(1.0) == ANALOG_CHARGE(1.0));
+    //mA * h = mAh, see toHoursBasis
+    STATIC_ASSERT((Units::IsProduct<Units::Milliamp, Units::Hour, Units::MilliampHour>::ok));
 
     uint32_t retu;
     ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
@@ -403,10 +422,11 @@ AnalogInputs::ValueType AnalogInputs::getEout()
         retu = i_Eout_;
     }
 
-    //check units
-    STATIC_ASSERT(uint32_t(ANALOG_AMP(1.0))*ANALOG_VOLT(1.0)
+    //mA * mV / (DIVIDER * dt) * h = 2 * cWh, see doSlowInterrupt and toHoursBasis
+    STATIC_ASSERT((Units::CheckDimension<Units::Centiwatt, Units::Hour, 1, Units::CentiwattHour>::ok));
+    STATIC_ASSERT(Units::Milliamp::scale * Units::Millivolt::scale
             / (ANALOG_INPUTS_E_OUT_DIVIDER*ANALOG_INPUTS_E_OUT_dt_FACTOR)
-            == 2 * ANALOG_WATTH(1.0));
+            == 2 * Units::CentiwattHour::scale);
     retu /= 2;
 
     return toHoursBasis(retu);
@@ -449,6 +469,7 @@ void AnalogInputs::setRealBasedOnAvr(AnalogInputs::Name name)
 
 void AnalogInputs::finalizeFullMeasurement()
 {
+    PROFILE_ZONE(AnalogInputs);
     uint16_t avrCount;
     ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
         avrCount = i_avrCount_;
@@ -596,14 +617,44 @@ void AnalogInputs::finalizeFullVirtualMeasurement()
         IoutValue = getRealValue(Ismps);
     }
 
-    uint32_t P = IoutValue;
-    P *= out;
-    P /= 10000;
-    setReal(Pout, P);
-
     setReal(Iout, IoutValue);
     setReal(Cout, getCharge());
-    setReal(Eout, getEout());
+
+    lazyDirty_ = LAZY_ALL;
+}
+
+AnalogInputs::ValueType AnalogInputs::getRealValue(Name name)
+{
+    if(name >= LAZY_FIRST && name <= LAZY_LAST) {
+        uint8_t bit = 1 << (name - LAZY_FIRST);
+        if(lazyDirty_ & bit) {
+            lazyDirty_ ^= bit;
+            finalizeLazyVirtualMeasurement(name);
+        }
+    }
+    return real_[name];
+}
+
+void AnalogInputs::finalizeLazyVirtualMeasurement(Name name)
+{
+    //all dependencies (Iout, VoutBalancer) are calculated in finalizeFullVirtualMeasurement
+    ValueType real;
+    if(name == Pout) {
+        real = Units::multiply<Units::Centiwatt>(
+                Units::value<Units::Milliamp, ANALOG_INPUTS_MAX_IOUT>(real_[Iout]),
+                Units::value<Units::Millivolt, MAX_CHARGE_V>(real_[VoutBalancer]));
+    } else {
+        real = getEout();
+    }
+    //setReal for every full measurement since the last evaluation
+    uint8_t i = name - LAZY_FIRST;
+    uint16_t n = calculationCount_ - lazyCount_[i];
+    lazyCount_[i] = calculationCount_;
+    if(absDiff(real_[name], real) > STABLE_VALUE_ERROR)
+        stableCount_[name] = 0;
+    else
+        stableCount_[name] += n;
+    real_[name] = real;
 }
 
 void AnalogInputs::setReal(Name name, ValueType real)
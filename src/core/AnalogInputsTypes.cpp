@@ -20,8 +20,11 @@
 #include <stdint.h>
 
 #include "AnalogInputsTypes.h"
+#include "Units.h"
 
 AnalogInputs::ValueType AnalogInputs::evalI(AnalogInputs::ValueType P, AnalogInputs::ValueType U) {
+    //cW / mV = mA, divided in two steps (rounding as before Units.h)
+    STATIC_ASSERT((Units::CheckDimension<Units::Centiwatt, Units::Millivolt, -1, Units::Milliamp>::ok));
     uint32_t i = P;
     i *= ANALOG_VOLT(1);
     i /= U;
@@ -32,6 +32,7 @@
 #include "Screen.h"
 #include "helper.h"
 #include "memory.h"
+#include "Thermal.h"
 
 
 void setup()
@@ -44,6 +45,9 @@ void setup()
     SMPS::initialize();
     Discharger::initialize();
     AnalogInputs::initialize();
+#ifdef ENABLE_T_INTERNAL
+    Thermal::initialize();
+#endif
     Serial::initialize();
 
 #ifdef ENABLE_STACK_INFO
@@ -20,12 +20,18 @@
 
 #include <AnalogInputsTypes.h>
 
+//display geometry, a target with a 20x4 display redefines them
+//in its HardwareConfig.h (see LcdLayout.h)
 #define LCD_LINES               2
 #define LCD_COLUMNS             16
 
 #define ENABLE_SERIAL_LOG
 #define ENABLE_TIME_LIMIT
 #define ENABLE_LCD_RAM_CG
+//cell voltage bars and the current graph (needs ENABLE_LCD_RAM_CG, see LcdGlyph.h)
+//#define ENABLE_LCD_GLYPHS
+//send the LCD data from the timer interrupt (one nibble per interrupt)
+//#define ENABLE_LCD_ASYNC
 #define ENABLE_SCREEN_ANIMATION
 //#define ENABLE_SCREEN_KNIGHTRIDEREFFECT
 
@@ -43,6 +49,27 @@
  */
 //#define ENABLE_DYNAMIC_MAX_POWER
 
+/*
+ * limit the charge power when the power supply voltage sags
+ * (e.g. a car battery), see InputPowerLimit.h
+ */
+//#define ENABLE_INPUT_POWER_LIMIT
+
+//Kalman filter state of charge and ETA (see StateOfCharge.h)
+//#define ENABLE_STATE_OF_CHARGE
+//constant power and constant resistance discharge (see PowerDischargeStrategy.h)
+//#define ENABLE_POWER_DISCHARGE
+//"measure R" program (see ResistanceStrategy.h)
+//#define ENABLE_PROGRAM_MEASURE_R
+//"sequence" program (see Sequencer.h)
+//#define ENABLE_PROGRAM_SEQUENCE
+
+/*
+ * measure the main loop zones (see Profile.h),
+ * sent in the SerialLog channel 4 (UART: debug or higher)
+ */
+//#define ENABLE_PROFILE
+
 #define STRINGS_HEADER "strings/standard.h"
 
 #define CHEALI_CHARGER_ARCHITECTURE                     (CHEALI_CHARGER_ARCHITECTURE_CPU + CHEALI_CHARGER_ARCHITECTURE_GENERIC)
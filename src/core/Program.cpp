@@ -24,8 +24,10 @@
 #include "SimpleChargeStrategy.h"
 #include "TheveninChargeStrategy.h"
 #include "TheveninDischargeStrategy.h"
+#include "PowerDischargeStrategy.h"
 #include "DeltaChargeStrategy.h"
 #include "StorageStrategy.h"
+#include "ResistanceStrategy.h"
 #include "Balancer.h"
 #include "Monitor.h"
 #include "memory.h"
@@ -35,6 +37,7 @@
 #include "SerialLog.h"
 #include "DelayStrategy.h"
 #include "ProgramDCcycle.h"
+#include "Sequencer.h"
 #include "Calibration.h"
 
 namespace Program {
@@ -50,6 +53,7 @@ namespace Program {
     void setupBalance();
     void setupDeltaCharge();
     void setupPowerSupplyCharge();
+    void setupResistance();
     void setupProgramType(ProgramType prog);
 
     void dischargeOutputCapacitor();
@@ -62,8 +66,7 @@ bool Program::startInfo()
     Strategy::strategy = &StartInfoStrategy::vtable;
     Strategy::exitImmediately = true;
     Strategy::doBalance = false;
-    if(ProgramData::isLiXX()) {
-        //usues balance port
+    if(ProgramData::hasBalancePort()) {
         Strategy::doBalance = true;
     }
     return Strategy::doStrategy() == Strategy::COMPLETE;
@@ -88,7 +91,11 @@ void Program::setupDeltaCharge()
 void Program::setupDischarge()
 {
     Strategy::setVI(ProgramData::VDischarged, false);
-    Strategy::strategy = &TheveninDischargeStrategy::vtable;
+    if(ProgramData::getDischargeMode() == ProgramData::DischargeCurrent) {
+        Strategy::strategy = &TheveninDischargeStrategy::vtable;
+    } else {
+        Strategy::strategy = &PowerDischargeStrategy::vtable;
+    }
 }
 
 void Program::setupPowerSupplyCharge()
@@ -97,6 +104,11 @@ void Program::setupPowerSupplyCharge()
     Strategy::strategy = &SimpleChargeStrategy::vtable;
 }
 
+void Program::setupResistance()
+{
+    Strategy::setVI(ProgramData::VDischarged, false);
+    Strategy::strategy = &ResistanceStrategy::vtable;
+}
 
 void Program::setupBalance()
 {
@@ -109,12 +121,16 @@ void Program::setupProgramType(ProgramType prog) {
     switch(prog) {
     case Program::CapacityCheck:
     case Program::Charge:
-        if(ProgramData::isNiXX()) {
+        switch(ProgramData::getChargeMethod()) {
+        case ProgramData::ChargeDelta:
             setupDeltaCharge();
-        } else if (ProgramData::isPowerSupply()) {
+            break;
+        case ProgramData::ChargeSimple:
             setupPowerSupplyCharge();
-        } else {
+            break;
+        default:
             setupTheveninCharge();
+            break;
         }
         break;
     case Program::ChargeBalance:
@@ -139,6 +155,11 @@ void Program::setupProgramType(ProgramType prog) {
         Strategy::doBalance = true;
         setupStorage();
         break;
+#ifdef ENABLE_PROGRAM_MEASURE_R
+    case Program::MeasureResistance:
+        setupResistance();
+        break;
+#endif
     default:
         break;
     }
@@ -161,6 +182,10 @@ Strategy::statusType Program::runWithoutInfo(ProgramType prog)
             return ProgramDCcycle::runDCcycle(1, 3);
         case Program::DischargeChargeCycle:
             return ProgramDCcycle::runDCcycle(0, ProgramData::battery.DCcycles*2 - 1);
+#ifdef ENABLE_PROGRAM_SEQUENCE
+        case Program::Sequence:
+            return Sequencer::run();
+#endif
         default:
             return Strategy::doStrategy();
     }
@@ -26,6 +26,8 @@ namespace Program {
     enum ProgramType {
         Charge, ChargeBalance, Balance, Discharge, FastCharge,
         Storage, StorageBalance, DischargeChargeCycle, CapacityCheck,
+        MeasureResistance,
+        Sequence,
         EditBattery,
         Calibrate,
         LAST_PROGRAM_TYPE};
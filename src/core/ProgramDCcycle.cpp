@@ -30,7 +30,8 @@ namespace ProgramDCcycle {
 
     Strategy::statusType runDCRestTime()
     {
-        DelayStrategy::setDelay(ProgramData::battery.DCRestTime);
+        //DCRestTime is the upper limit, the rest ends when the battery voltage has relaxed
+        DelayStrategy::setRelaxationDelay(ProgramData::battery.DCRestTime);
         Strategy::strategy = &DelayStrategy::vtable;
         return Strategy::doStrategy();
     }
@@ -40,15 +41,17 @@ namespace ProgramDCcycle {
 Strategy::statusType ProgramDCcycle::runDCcycle(uint8_t firstCycle, uint8_t lastCycle)
 {
     Strategy::statusType status;
+    //the last cycle keeps the callers exitImmediately (see Sequencer)
+    bool exitImmediately = Strategy::exitImmediately;
     Strategy::exitImmediately = true;
     currentCycle = firstCycle;
     while(true) {
         if (currentCycle == lastCycle) {
-            Strategy::exitImmediately = false;
+            Strategy::exitImmediately = exitImmediately;
         }
 
         status = Program::runWithoutInfo(currentCycle & 1 ? Program::Charge : Program::Discharge);
-        if(status != Strategy::COMPLETE || (!Strategy::exitImmediately)) break;
+        if(status != Strategy::COMPLETE || currentCycle == lastCycle) break;
 
         currentCycle++;
         Program::resetAccumulatedMeasurements();
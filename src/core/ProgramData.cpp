@@ -26,15 +26,24 @@
 ProgramData::Battery ProgramData::battery;
 
 //battery voltage limits, see also: ProgramData::getVoltagePerCell, ProgramData::getVoltage
-const AnalogInputs::ValueType voltsPerCell[][ProgramData::LAST_VOLTAGE_TYPE] PROGMEM  =
+//a new battery type needs only: a BatteryType, a batteryString and a row here
+#define CH_BALANCE  CHEMISTRY_BALANCE_PORT
+#define CH_NO_CELLS CHEMISTRY_NO_CELLS
+
+const ProgramData::Chemistry ProgramData::chemistry[] PROGMEM  =
 {
-//          { VNominal,           VCharged,           VDischarged,        VStorage,           VvalidEmpty};
-/*None*/    { 1,                  1,                  1,                  1,                  1},
-/*NiCd*/    { ANALOG_VOLT(1.200), ANALOG_VOLT(1.800), ANALOG_VOLT(0.850), 0,                  ANALOG_VOLT(0.850)},
+//           {{VNominal,           VCharged,           VDischarged,        VStorage,           VvalidEmpty},
+//              class,        charge,         flags,       IcDivider, deltaV, VdNominalCells, ocv}
+/*None*/    {{ 1,                  1,                  1,                  1,                  1},
+                ClassUnknown, ChargeThevenin, 0,           1,         0,      0,              OcvLinear},
+/*NiCd*/    {{ ANALOG_VOLT(1.200), ANALOG_VOLT(1.800), ANALOG_VOLT(0.850), 0,                  ANALOG_VOLT(0.850)},
+                ClassNiXX,    ChargeDelta,    0,           1,         -15,    0,              OcvNiXX},
 //http://en.wikipedia.org/wiki/Nickel%E2%80%93metal_hydride_battery
 //http://eu.industrial.panasonic.com/sites/default/pidseu/files/downloads/files/ni-mh-handbook-2014_interactive.pdf
 //http://www6.zetatalk.com/docs/Batteries/Chemistry/Duracell_Ni-MH_Rechargeable_Batteries_2007.pdf
-/*NiMH*/    { ANALOG_VOLT(1.200), ANALOG_VOLT(1.800), ANALOG_VOLT(1.000), 0,                  ANALOG_VOLT(1.000)},
+//page 11: "Discharge end voltage" - above 6 cells: (cells-1)*1.2V
+/*NiMH*/    {{ ANALOG_VOLT(1.200), ANALOG_VOLT(1.800), ANALOG_VOLT(1.000), 0,                  ANALOG_VOLT(1.000)},
+                ClassNiXX,    ChargeDelta,    0,           1,         -5,     6,              OcvNiXX},
 
 //Pb based on:
 //http://www.battery-usa.com/Catalog/NPAppManual%28Rev0500%29.pdf
@@ -42,47 +51,126 @@ const AnalogInputs::ValueType voltsPerCell[][ProgramData::LAST_VOLTAGE_TYPE] PRO
 //charge end current 0.05C (end current = start current / 5) (stage 2 - constant voltage)
 //Stage 3 (float charge) - not implemented
 //http://batteryuniversity.com/learn/article/charging_the_lead_acid_battery
-/*Pb*/      { ANALOG_VOLT(2.000), ANALOG_VOLT(2.450), ANALOG_VOLT(1.750), ANALOG_VOLT(0.000), ANALOG_VOLT(1.900)},
+/*Pb*/      {{ ANALOG_VOLT(2.000), ANALOG_VOLT(2.450), ANALOG_VOLT(1.750), ANALOG_VOLT(0.000), ANALOG_VOLT(1.900)},
+                ClassPb,      ChargeThevenin, 0,           4,         0,      0,              OcvPb},
 
 //LiXX
 //based on imaxB6 manual
 //https://github.com/stawel/cheali-charger/issues/184
-/*Life*/    { ANALOG_VOLT(3.300), ANALOG_VOLT(3.600), ANALOG_VOLT(2.500), ANALOG_VOLT(3.300), ANALOG_VOLT(3.000)},
+/*Life*/    {{ ANALOG_VOLT(3.300), ANALOG_VOLT(3.600), ANALOG_VOLT(2.500), ANALOG_VOLT(3.300), ANALOG_VOLT(3.000)},
+                ClassLiXX,    ChargeThevenin, CH_BALANCE,  1,         0,      0,              OcvLife},
 //based on imaxB6 manual
-/*Lilo*/    { ANALOG_VOLT(3.600), ANALOG_VOLT(4.100), ANALOG_VOLT(2.500), ANALOG_VOLT(3.750), ANALOG_VOLT(3.500)},
-/*LiPo*/    { ANALOG_VOLT(3.700), ANALOG_VOLT(4.200), ANALOG_VOLT(3.000), ANALOG_VOLT(3.850), ANALOG_VOLT(3.209)},
-/*Li430*/   { ANALOG_VOLT(3.700), ANALOG_VOLT(4.300), ANALOG_VOLT(3.000), ANALOG_VOLT(3.850), ANALOG_VOLT(3.209)},
-/*Li435*/   { ANALOG_VOLT(3.700), ANALOG_VOLT(4.350), ANALOG_VOLT(3.000), ANALOG_VOLT(3.850), ANALOG_VOLT(3.209)},
+/*Lilo*/    {{ ANALOG_VOLT(3.600), ANALOG_VOLT(4.100), ANALOG_VOLT(2.500), ANALOG_VOLT(3.750), ANALOG_VOLT(3.500)},
+                ClassLiXX,    ChargeThevenin, CH_BALANCE,  1,         0,      0,              OcvLilo},
+/*LiPo*/    {{ ANALOG_VOLT(3.700), ANALOG_VOLT(4.200), ANALOG_VOLT(3.000), ANALOG_VOLT(3.850), ANALOG_VOLT(3.209)},
+                ClassLiXX,    ChargeThevenin, CH_BALANCE,  1,         0,      0,              OcvLiPo},
+/*Li430*/   {{ ANALOG_VOLT(3.700), ANALOG_VOLT(4.300), ANALOG_VOLT(3.000), ANALOG_VOLT(3.850), ANALOG_VOLT(3.209)},
+                ClassLiXX,    ChargeThevenin, CH_BALANCE,  1,         0,      0,              OcvLi430},
+/*Li435*/   {{ ANALOG_VOLT(3.700), ANALOG_VOLT(4.350), ANALOG_VOLT(3.000), ANALOG_VOLT(3.850), ANALOG_VOLT(3.209)},
+                ClassLiXX,    ChargeThevenin, CH_BALANCE,  1,         0,      0,              OcvLi435},
 
 //based on "mars" settings, TODO: find datasheet
-/*NiZn*/    { ANALOG_VOLT(1.600), ANALOG_VOLT(1.900), ANALOG_VOLT(1.300), ANALOG_VOLT(1.600), ANALOG_VOLT(1.400)},
+/*NiZn*/    {{ ANALOG_VOLT(1.600), ANALOG_VOLT(1.900), ANALOG_VOLT(1.300), ANALOG_VOLT(1.600), ANALOG_VOLT(1.400)},
+                ClassNiZn,    ChargeThevenin, 0,           1,         0,      0,              OcvNiZn},
 
-/*Unknown*/ { 1,                  ANALOG_VOLT(4.000), ANALOG_VOLT(2.000), 1,                  1},
+/*Unknown*/ {{ 1,                  ANALOG_VOLT(4.000), ANALOG_VOLT(2.000), 1,                  1},
+                ClassUnknown, ChargeThevenin, CH_NO_CELLS, 1,         0,      0,              OcvLinear},
 //PowerSupply
-/*LED*/     { 1,                  ANALOG_VOLT(4.000), 1,                  1,                  1},
+/*LED*/     {{ 1,                  ANALOG_VOLT(4.000), 1,                  1,                  1},
+                ClassLED,     ChargeSimple,   CH_NO_CELLS, 1,         0,      0,              OcvLinear},
 
 };
 
+STATIC_ASSERT(sizeOfArray(ProgramData::chemistry) == ProgramData::LAST_BATTERY_TYPE);
+
+//open circuit voltage per cell at 0%, 10%, .., 100%, see Chemistry::ocv
+const AnalogInputs::ValueType ProgramData::ocvCurve[][CHEMISTRY_OCV_POINTS] PROGMEM =
+{
+/*NiXX*/    {ANALOG_VOLT(1.100), ANALOG_VOLT(1.200), ANALOG_VOLT(1.230), ANALOG_VOLT(1.250), ANALOG_VOLT(1.260), ANALOG_VOLT(1.270),
+                ANALOG_VOLT(1.280), ANALOG_VOLT(1.290), ANALOG_VOLT(1.310), ANALOG_VOLT(1.340), ANALOG_VOLT(1.400)},
+/*Pb*/      {ANALOG_VOLT(1.930), ANALOG_VOLT(1.950), ANALOG_VOLT(1.970), ANALOG_VOLT(1.985), ANALOG_VOLT(2.005), ANALOG_VOLT(2.025),
+                ANALOG_VOLT(2.045), ANALOG_VOLT(2.065), ANALOG_VOLT(2.085), ANALOG_VOLT(2.100), ANALOG_VOLT(2.120)},
+/*Life*/    {ANALOG_VOLT(2.800), ANALOG_VOLT(3.200), ANALOG_VOLT(3.250), ANALOG_VOLT(3.280), ANALOG_VOLT(3.290), ANALOG_VOLT(3.300),
+                ANALOG_VOLT(3.310), ANALOG_VOLT(3.320), ANALOG_VOLT(3.330), ANALOG_VOLT(3.350), ANALOG_VOLT(3.450)},
+/*Lilo*/    {ANALOG_VOLT(3.300), ANALOG_VOLT(3.600), ANALOG_VOLT(3.660), ANALOG_VOLT(3.700), ANALOG_VOLT(3.730), ANALOG_VOLT(3.770),
+                ANALOG_VOLT(3.820), ANALOG_VOLT(3.880), ANALOG_VOLT(3.950), ANALOG_VOLT(4.020), ANALOG_VOLT(4.100)},
+/*LiPo*/    {ANALOG_VOLT(3.300), ANALOG_VOLT(3.680), ANALOG_VOLT(3.740), ANALOG_VOLT(3.770), ANALOG_VOLT(3.790), ANALOG_VOLT(3.820),
+                ANALOG_VOLT(3.870), ANALOG_VOLT(3.920), ANALOG_VOLT(3.980), ANALOG_VOLT(4.060), ANALOG_VOLT(4.190)},
+/*Li430*/   {ANALOG_VOLT(3.300), ANALOG_VOLT(3.680), ANALOG_VOLT(3.740), ANALOG_VOLT(3.780), ANALOG_VOLT(3.810), ANALOG_VOLT(3.850),
+                ANALOG_VOLT(3.900), ANALOG_VOLT(3.960), ANALOG_VOLT(4.030), ANALOG_VOLT(4.130), ANALOG_VOLT(4.280)},
+/*Li435*/   {ANALOG_VOLT(3.300), ANALOG_VOLT(3.680), ANALOG_VOLT(3.750), ANALOG_VOLT(3.790), ANALOG_VOLT(3.820), ANALOG_VOLT(3.860),
+                ANALOG_VOLT(3.920), ANALOG_VOLT(3.980), ANALOG_VOLT(4.050), ANALOG_VOLT(4.160), ANALOG_VOLT(4.330)},
+/*NiZn*/    {ANALOG_VOLT(1.500), ANALOG_VOLT(1.650), ANALOG_VOLT(1.700), ANALOG_VOLT(1.720), ANALOG_VOLT(1.740), ANALOG_VOLT(1.760),
+                ANALOG_VOLT(1.780), ANALOG_VOLT(1.800), ANALOG_VOLT(1.820), ANALOG_VOLT(1.840), ANALOG_VOLT(1.870)},
+};
+
+STATIC_ASSERT(sizeOfArray(ProgramData::ocvCurve) == ProgramData::OcvLinear);
+
+bool ProgramData::hasFlag(uint8_t flag)
+{
+    return pgm::read(&getChemistry()->flags) & flag;
+}
+
+ProgramData::ChargeMethod ProgramData::getChargeMethod()
+{
+    return ChargeMethod(pgm::read(&getChemistry()->chargeMethod));
+}
+
+ProgramData::BatteryClass ProgramData::getBatteryClass()
+{
+    return BatteryClass(pgm::read(&getChemistry()->batteryClass));
+}
+
 uint16_t ProgramData::getDefaultVoltagePerCell(VoltageType type)
 {
-    STATIC_ASSERT(sizeOfArray(voltsPerCell) == ProgramData::LAST_BATTERY_TYPE);
-    uint16_t result = pgm::read(&voltsPerCell[battery.type][type]);
-    return result;
+    return pgm::read(&getChemistry()->voltsPerCell[type]);
 }
+
 uint16_t ProgramData::getDefaultVoltage(VoltageType type)
 {
     uint16_t cells = battery.cells;
     uint16_t voltage = getDefaultVoltagePerCell(type);
 
-    if(type == VDischarged && battery.type == NiMH && cells > 6) {
-        //based on http://eu.industrial.panasonic.com/sites/default/pidseu/files/downloads/files/ni-mh-handbook-2014_interactive.pdf
-        //page 11: "Discharge end voltage"
-        cells--;
-        voltage = ANALOG_VOLT(1.200);
+    if(type == VDischarged) {
+        uint8_t n = pgm::read(&getChemistry()->VdNominalCells);
+        if(n && cells > n) {
+            cells--;
+            voltage = getDefaultVoltagePerCell(VNominal);
+        }
     }
     return cells * voltage;
 }
 
+AnalogInputs::ValueType ProgramData::getOcvPoint(uint8_t i)
+{
+    uint8_t t = pgm::read(&getChemistry()->ocv);
+    if(t == OcvLinear) {
+        //the old linear model between VvalidEmpty and VCharged
+        AnalogInputs::ValueType v0 = getDefaultVoltagePerCell(VvalidEmpty);
+        AnalogInputs::ValueType v1 = getDefaultVoltagePerCell(VCharged);
+        return v0 + uint32_t(v1 - v0) * i / (CHEMISTRY_OCV_POINTS - 1);
+    }
+    return pgm::read(&ocvCurve[t][i]);
+}
+
+uint16_t ProgramData::ocvToSoC(AnalogInputs::ValueType v)
+{
+    AnalogInputs::ValueType v0 = getOcvPoint(0), v1;
+    if(v <= v0)
+        return 0;
+    for(uint8_t i = 1; i < CHEMISTRY_OCV_POINTS; i++) {
+        v1 = getOcvPoint(i);
+        if(v < v1) {
+            uint32_t soc = v - v0;
+            soc *= CHEMISTRY_SOC_MAX / (CHEMISTRY_OCV_POINTS - 1);
+            soc /= v1 - v0;
+            return soc + (i - 1) * (CHEMISTRY_SOC_MAX / (CHEMISTRY_OCV_POINTS - 1));
+        }
+        v0 = v1;
+    }
+    return CHEMISTRY_SOC_MAX;
+}
+
 uint16_t ProgramData::getVoltage(VoltageType type) {
     uint16_t cells = battery.cells;
     uint16_t voltage = getDefaultVoltagePerCell(type);
@@ -93,8 +181,7 @@ uint16_t ProgramData::getVoltage(VoltageType type) {
     } else if (type == VStorage) {
         voltage = battery.Vs_per_cell;
     }
-    //TODO:type == VDischarge && battery.type == NiMH && cells > 6
-    //see getDefaultVoltage
+    //TODO: Chemistry::VdNominalCells, see getDefaultVoltage
     return cells * voltage;
 }
 
@@ -116,27 +203,6 @@ const char * const  ProgramData::batteryString[] PROGMEM = {
 
 STATIC_ASSERT(sizeOfArray(ProgramData::batteryString) == ProgramData::LAST_BATTERY_TYPE);
 
-const ProgramData::BatteryClass ProgramData::batteryClassMap[] PROGMEM = {
-/*None*/    ClassUnknown,
-/*NiCd*/    ClassNiXX,
-/*NiMH*/    ClassNiXX,
-/*Pb*/      ClassPb,
-/*Life*/    ClassLiXX,
-/*Lilo*/    ClassLiXX,
-/*Lipo*/    ClassLiXX,
-/*Li430*/   ClassLiXX,
-/*Li435*/   ClassLiXX,
-/*NiZn*/    ClassNiZn,
-/*Unknown*/ ClassUnknown,
-/*LED*/     ClassLED
-};
-
-
-ProgramData::BatteryClass ProgramData::getBatteryClass() {
-    STATIC_ASSERT(sizeOfArray(ProgramData::batteryClassMap) == ProgramData::LAST_BATTERY_TYPE);
-    return pgm::read(&ProgramData::batteryClassMap[battery.type]);
-}
-
 uint16_t ProgramData::getCapacityLimit()
 {
     uint32_t cap = battery.capacity;
@@ -183,12 +249,19 @@ uint16_t ProgramData::getMaxId()
 
 uint16_t ProgramData::getMaxCells()
 {
-    if(battery.type == UnknownBatteryType || battery.type == LED)
+    if(!hasCells())
         return 1;
     uint16_t v = getDefaultVoltagePerCell(VCharged);
     return MAX_CHARGE_V / v;
 }
 
+namespace {
+    void checkRange(uint16_t *x, uint16_t min, uint16_t max) {
+        if(*x < min) *x = min;
+        if(*x > max) *x = max;
+    }
+}
+
 void ProgramData::check()
 {
     uint16_t v;
@@ -226,7 +299,44 @@ void ProgramData::check()
     v = settings.minId;
     if(battery.Id < v) battery.Id = v;
     if(battery.minId < v) battery.minId = v;
+
+    //the sequencer "Set" can write any value, see also ProgramDataMenu::editData
+    v = hasCells() ? ANALOG_VOLT(5.0) : MAX_CHARGE_V;
+    checkRange(&battery.Vc_per_cell, 0, v);
+    checkRange(&battery.Vd_per_cell, 0, v);
+    checkRange(&battery.capCutoff, 1, 250);
+    checkRange(&battery.DCRestTime, 1, 99);
+    checkRange(&battery.DCcycles, 0, 5);
+
+    if(isNiXX()) {
+        if(battery.deltaV > 0) battery.deltaV = 0;
+        if(battery.deltaV < -ANALOG_VOLT(0.020)) battery.deltaV = -ANALOG_VOLT(0.020);
+        checkRange(&battery.deltaVIgnoreTime, 1, 30);
+    } else {
+        checkRange(&battery.Vs_per_cell, 0, ANALOG_VOLT(5.0));
+        checkRange(&battery.balancerError, ANALOG_VOLT(0.003), ANALOG_VOLT(0.200));
+        if(battery.dischargeMode >= LAST_DISCHARGE_MODE) {
+            battery.dischargeMode = DischargeCurrent;
+        }
+        //PowerDischargeStrategy divides by dischargeValue
+        if(battery.dischargeMode == DischargePower) {
+            checkRange(&battery.dischargeValue, ANALOG_WATT(0.1), MAX_DISCHARGE_P);
+        } else if(battery.dischargeMode == DischargeResistance) {
+            checkRange(&battery.dischargeValue, ANALOG_OHM(0.1), ANALOG_OHM(65.0));
+        }
+    }
+}
+
+#ifdef ENABLE_POWER_DISCHARGE
+ProgramData::DischargeMode ProgramData::getDischargeMode()
+{
+    //NiXX: dischargeMode overlaps deltaVIgnoreTime (see Battery)
+    if(isNiXX())
+        return DischargeCurrent;
+    return DischargeMode(battery.dischargeMode);
 }
+#endif
+
 
 void ProgramData::loadProgramData(uint8_t index)
 {
@@ -271,16 +381,13 @@ void ProgramData::changedType()
 
     if(isNiXX()) {
         battery.enable_deltaV = true;
-        if(battery.type == NiMH) {
-            battery.deltaV = -ANALOG_VOLT(0.005);
-        } else {
-            battery.deltaV = -ANALOG_VOLT(0.015);
-        }
+        battery.deltaV = pgm::read(&getChemistry()->deltaV);
         battery.deltaVIgnoreTime = 3;
         battery.deltaT = ANALOG_CELCIUS(1);
         battery.DCcycles = 5;
     } else {
         battery.balancerError = ANALOG_VOLT(0.008);
+        battery.dischargeMode = DischargeCurrent;
         battery.Vs_per_cell = getDefaultVoltagePerCell(VStorage);
     }
     changedCapacity();
@@ -299,12 +406,19 @@ void ProgramData::changedId()
     ProgramData::battery.minId = ProgramData::battery.Id/10;
 }
 
+void ProgramData::changedDischargeMode()
+{
+    if(battery.dischargeMode == DischargePower) {
+        battery.dischargeValue = ANALOG_WATT(10.0);
+    } else if(battery.dischargeMode == DischargeResistance) {
+        battery.dischargeValue = ANALOG_OHM(10.0);
+    }
+}
+
 void ProgramData::changedCapacity()
 {
     ProgramData::check();
-    ProgramData::battery.Ic = ProgramData::battery.capacity;
-    if(ProgramData::battery.type == Pb)
-        ProgramData::battery.Ic/=4;
+    ProgramData::battery.Ic = ProgramData::battery.capacity / pgm::read(&getChemistry()->IcDivider);
 
     changedIc();
     ProgramData::battery.Id = ProgramData::battery.capacity;
@@ -31,6 +31,32 @@ namespace ProgramData {
     enum BatteryClass {ClassNiXX, ClassPb, ClassLiXX, ClassNiZn, ClassUnknown, ClassLED, LAST_BATTERY_CLASS};
     enum BatteryType {NoneBatteryType, NiCd, NiMH, Pb, Life, Lilo, Lipo, Li430, Li435, NiZn, UnknownBatteryType, LED, LAST_BATTERY_TYPE};
     enum VoltageType {VNominal, VCharged, VDischarged, VStorage, VvalidEmpty, LAST_VOLTAGE_TYPE};
+    enum DischargeMode {DischargeCurrent, DischargePower, DischargeResistance, LAST_DISCHARGE_MODE};
+    enum ChargeMethod {ChargeThevenin, ChargeDelta, ChargeSimple};
+
+//Chemistry::flags
+#define CHEMISTRY_BALANCE_PORT      1   //uses the balance port
+#define CHEMISTRY_NO_CELLS          2   //set up by the voltage, not by the cell count
+
+//open circuit voltage curve points: 0%, 10%, .., 100%
+#define CHEMISTRY_OCV_POINTS        11
+//state of charge in 0.01% units, see ocvToSoC
+#define CHEMISTRY_SOC_MAX           10000
+
+    //Chemistry::ocv, OcvLinear - linear between VvalidEmpty and VCharged
+    enum OcvCurve {OcvNiXX, OcvPb, OcvLife, OcvLilo, OcvLiPo, OcvLi430, OcvLi435, OcvNiZn, OcvLinear};
+
+    //everything that depends on the battery type, see chemistry[]
+    struct Chemistry {
+        AnalogInputs::ValueType voltsPerCell[LAST_VOLTAGE_TYPE];
+        uint8_t batteryClass;       //BatteryClass: program menu, edit menu and screen pages
+        uint8_t chargeMethod;       //ChargeMethod
+        uint8_t flags;              //CHEMISTRY_*
+        uint8_t IcDivider;          //default Ic = capacity / IcDivider
+        int8_t deltaV;              //default -dV per cell [mV], NiXX only
+        uint8_t VdNominalCells;     //above this cell count the discharge ends at (cells-1)*VNominal, 0 - disabled
+        uint8_t ocv;                //OcvCurve, see ocvCurve[]
+    };
 
 
     struct Battery {
@@ -57,9 +83,11 @@ namespace ProgramData {
         uint16_t capCutoff;
 
         union {
-            struct { //LiXX
+            struct { //LiXX, NiZn, Pb, Unknown
                 uint16_t Vs_per_cell; // storage
                 uint16_t balancerError;
+                uint16_t dischargeMode;
+                uint16_t dischargeValue; // P or R, see dischargeMode
             };
             struct { //NiXX
                 uint16_t enable_deltaV;
@@ -75,7 +103,15 @@ namespace ProgramData {
 
     extern Battery battery;
     extern const char * const batteryString[];
-    extern const BatteryClass batteryClassMap[];
+    extern const Chemistry chemistry[];
+    //open circuit voltage per cell (StateOfCharge, Balancer)
+    extern const AnalogInputs::ValueType ocvCurve[OcvLinear][CHEMISTRY_OCV_POINTS];
+
+    inline const Chemistry * getChemistry() { return &chemistry[battery.type]; }
+    bool hasFlag(uint8_t flag);
+    inline bool hasBalancePort() { return hasFlag(CHEMISTRY_BALANCE_PORT); }
+    inline bool hasCells() { return !hasFlag(CHEMISTRY_NO_CELLS); }
+    ChargeMethod getChargeMethod();
 
     uint16_t getDefaultVoltagePerCell(VoltageType type = VNominal);
     uint16_t getDefaultVoltage(VoltageType type = VNominal);
@@ -83,6 +119,17 @@ namespace ProgramData {
     uint16_t getCapacityLimit();
     inline uint16_t getTimeLimit() {return battery.time; }
 
+    //open circuit voltage per cell at point i (0%, 10%, .., 100%) of the battery chemistry
+    AnalogInputs::ValueType getOcvPoint(uint8_t i);
+    //open circuit voltage per cell -> state of charge (0 - CHEMISTRY_SOC_MAX)
+    uint16_t ocvToSoC(AnalogInputs::ValueType v_per_cell);
+
+#ifdef ENABLE_POWER_DISCHARGE
+    DischargeMode getDischargeMode();
+#else
+    inline DischargeMode getDischargeMode() { return DischargeCurrent; }
+#endif
+
     int16_t getDeltaVLimit();
     inline int16_t getDeltaTLimit() {return battery.deltaT;}
 
@@ -96,6 +143,7 @@ namespace ProgramData {
     void changedCapacity();
     void changedIc();
     void changedId();
+    void changedDischargeMode();
 
     BatteryClass getBatteryClass();
 
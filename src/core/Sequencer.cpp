@@ -0,0 +1,216 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2016  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "Sequencer.h"
+#include "Program.h"
+#include "ProgramData.h"
+#include "DelayStrategy.h"
+#include "eeprom.h"
+#include "memory.h"
+#include "Screen.h"
+#include "LcdPrint.h"
+
+//#define ENABLE_DEBUG
+#include "debug.h"
+
+namespace Sequencer {
+    uint8_t pc_;
+
+    //nested loops: the Loop instruction address and its counter
+    struct LoopState {
+        uint8_t pc;
+        uint8_t count;
+    };
+    LoopState loops_[SEQUENCER_MAX_LOOPS];
+    uint8_t loopsSize_;
+    //max. number of instructions executed without running a program
+    const static uint16_t maxIdleSteps = 1000;
+
+    //the first battery field that can be changed (type, capacity and cells are fixed)
+    const static uint8_t firstSetField = offsetof(ProgramData::Battery, Ic) / 2;
+
+    uint8_t readByte(uint8_t adr) {
+        if(adr >= SEQUENCER_PROGRAM_SIZE)
+            return End;
+        return eeprom::read(&eeprom::data.sequence.code[adr]);
+    }
+
+    uint16_t readWord(uint8_t adr) {
+        uint16_t v = readByte(adr + 1);
+        v <<= 8;
+        return v + readByte(adr);
+    }
+
+    bool isProgramAllowed(uint8_t prog) {
+        return prog < Program::Sequence;
+    }
+
+    bool isProgramOpcode(uint8_t op) {
+        return op == Run || op == Rest;
+    }
+
+    //index in loops_ of the loop at pc, loopsSize_ if it is not running
+    uint8_t findLoop(uint8_t pc) {
+        uint8_t i = loopsSize_;
+        while(i > 0) {
+            i--;
+            if(loops_[i].pc == pc)
+                return i;
+        }
+        return loopsSize_;
+    }
+
+    uint8_t getLoopCount(uint8_t pc) {
+        uint8_t i = findLoop(pc);
+        if(i == loopsSize_)
+            return 0;
+        return loops_[i].count;
+    }
+
+    //true if no program is run after the instruction at pc
+    bool isLast(uint8_t pc) {
+        while(true) {
+            uint8_t op = readByte(pc);
+            if(op == Set) {
+                pc += 4;
+            } else if(op == Loop) {
+                if(getLoopCount(pc) + 1 < readByte(pc + 2)) return false;
+                pc += 3;
+            } else {
+                return op == End;
+            }
+        }
+    }
+
+    Strategy::statusType invalidCode() {
+        Screen::displayStrings(PSTR("sequence error\n"
+                                    "pc="));
+        lcdPrintUInt(pc_);
+        waitButtonPressed();
+        return Strategy::ERROR;
+    }
+
+    Strategy::statusType runProgram(uint8_t prog) {
+        if(!isProgramAllowed(prog))
+            return invalidCode();
+        Strategy::exitImmediately = !isLast(pc_);
+        Program::programType = Program::ProgramType(prog);
+        Strategy::statusType status = Program::runWithoutInfo(Program::programType);
+        Program::programType = Program::Sequence;
+        return status;
+    }
+
+    Strategy::statusType runRest(uint8_t minutes) {
+        Strategy::exitImmediately = !isLast(pc_);
+        Program::resetAccumulatedMeasurements();
+        DelayStrategy::setRelaxationDelay(minutes);
+        Strategy::strategy = &DelayStrategy::vtable;
+        return Strategy::doStrategy();
+    }
+
+    Strategy::statusType step() {
+        uint8_t op = readByte(pc_);
+        Strategy::statusType status = Strategy::COMPLETE;
+        LogDebug("pc=", pc_, " op=", op);
+        switch(op) {
+        case Run:
+            pc_ += 2;
+            status = runProgram(readByte(pc_ - 1));
+            break;
+        case Rest:
+            pc_ += 2;
+            status = runRest(readByte(pc_ - 1));
+            break;
+        case Set: {
+            uint8_t field = readByte(pc_ + 1);
+            if(field < firstSetField || field >= sizeof(ProgramData::Battery) / 2)
+                return invalidCode();
+            ((uint16_t*)&ProgramData::battery)[field] = readWord(pc_ + 2);
+            ProgramData::check();
+            pc_ += 4;
+            break;
+        }
+        case Loop: {
+            uint8_t i = findLoop(pc_);
+            if(i == loopsSize_) {
+                //a new (inner) loop
+                if(loopsSize_ == SEQUENCER_MAX_LOOPS)
+                    return invalidCode();
+                loops_[i].pc = pc_;
+                loops_[i].count = 0;
+            }
+            //forget the inner loops
+            loopsSize_ = i + 1;
+            if(loops_[i].count + 1 < readByte(pc_ + 2)) {
+                loops_[i].count++;
+                pc_ = readByte(pc_ + 1);
+            } else {
+                loopsSize_ = i;
+                pc_ += 3;
+            }
+            break;
+        }
+        case JumpIfLess: {
+            uint8_t name = readByte(pc_ + 1);
+            if(name >= AnalogInputs::ALL_INPUTS)
+                return invalidCode();
+            if(AnalogInputs::getRealValue(AnalogInputs::Name(name)) < readWord(pc_ + 2)) {
+                pc_ = readByte(pc_ + 4);
+            } else {
+                pc_ += 5;
+            }
+            break;
+        }
+        default:
+            return invalidCode();
+        }
+        return status;
+    }
+
+    Strategy::statusType runCode() {
+        Strategy::statusType status = Strategy::COMPLETE;
+        uint16_t idle = 0;
+        pc_ = 0;
+        loopsSize_ = 0;
+        while(status == Strategy::COMPLETE) {
+            uint8_t op = readByte(pc_);
+            if(op == End)
+                break;
+            if(isProgramOpcode(op)) idle = 0;
+            else if(idle++ > maxIdleSteps) return invalidCode();
+            status = step();
+        }
+        return status;
+    }
+}
+
+Strategy::statusType Sequencer::run()
+{
+    //Set changes the battery only for the sequence
+    ProgramData::Battery battery = ProgramData::battery;
+    Strategy::statusType status = runCode();
+    ProgramData::battery = battery;
+    return status;
+}
+
+void Sequencer::restoreDefault()
+{
+    for(uint8_t i = 0; i < SEQUENCER_PROGRAM_SIZE; i++) {
+        eeprom::write<uint8_t>(&eeprom::data.sequence.code[i], End);
+    }
+    eeprom::restoreSequenceCRC();
+}
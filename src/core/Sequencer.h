@@ -0,0 +1,57 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2016  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SEQUENCER_H_
+#define SEQUENCER_H_
+
+#include "Strategy.h"
+#include "cpu.h"
+
+//bytecode size, limited by the atmega32 eeprom (1kB)
+#ifndef SEQUENCER_PROGRAM_SIZE
+#define SEQUENCER_PROGRAM_SIZE 30
+#endif
+//max. loop nesting
+#define SEQUENCER_MAX_LOOPS 3
+
+/* program bytecode (16 bit values are little endian):
+ *  End                                         - 0xff, also an erased eeprom
+ *  Run     programType                         - run a program with the current battery
+ *  Rest    maxMinutes                          - wait until the battery voltage has relaxed
+ *  Set     field, value16                      - ProgramData::battery field (16 bit word index)
+ *  Loop    target, count                       - jump to target (count - 1) times,
+ *                                                max. SEQUENCER_MAX_LOOPS nested loops
+ *  JumpIfLess input, value16, target           - AnalogInputs::Name input
+ * see: utils/sequenceAssembler
+ */
+
+namespace Sequencer {
+
+    enum Opcode {Run = 1, Rest, Set, Loop, JumpIfLess, End = 0xff};
+
+    struct Data {
+        uint8_t code[SEQUENCER_PROGRAM_SIZE];
+    } CHEALI_EEPROM_PACKED;
+
+    extern uint8_t pc_;
+
+    Strategy::statusType run();
+    void restoreDefault();
+};
+
+
+#endif /* SEQUENCER_H_ */
@@ -0,0 +1,117 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef UNITS_H_
+#define UNITS_H_
+
+#include <stdint.h>
+#include "AnalogInputsTypes.h"
+#include "Utils.h"
+
+//compile time checked units for AnalogInputs::ValueType arithmetic, see ANALOG_VOLT, ANALOG_AMP, ...
+//everything is resolved by the compiler (C++98 templates, no constexpr): the generated
+//code is the same as the hand written uint32_t arithmetic
+namespace Units {
+
+    //dimension: exponents of volt, amp, hour and degree, value = real value * SCALE
+    template<int V, int A, int H, int T, uint32_t SCALE>
+    struct Unit {
+        enum { volt = V, amp = A, hour = H, degree = T };
+        static const uint32_t scale = SCALE;
+    };
+
+    typedef Unit<1, 0, 0, 0, 1000>  Millivolt;      //ANALOG_VOLT
+    typedef Unit<0, 1, 0, 0, 1000>  Milliamp;       //ANALOG_AMP
+    typedef Unit<1, 1, 0, 0, 100>   Centiwatt;      //ANALOG_WATT
+    typedef Unit<0, 1, 1, 0, 1000>  MilliampHour;   //ANALOG_CHARGE
+    typedef Unit<1, 1, 1, 0, 100>   CentiwattHour;  //ANALOG_WATTH
+    typedef Unit<1, -1, 0, 0, 1000> Milliohm;       //ANALOG_OHM
+    typedef Unit<0, 0, 0, 1, 100>   Centidegree;    //ANALOG_CELCIUS
+    typedef Unit<0, 0, 1, 0, 1>     Hour;
+
+    //dimension of U1 * U2 (SIGN = 1) or U1 / U2 (SIGN = -1) must be the dimension of R
+    template<class U1, class U2, int SIGN, class R>
+    struct CheckDimension {
+        enum {
+            ok = U1::volt + SIGN * U2::volt == R::volt && U1::amp + SIGN * U2::amp == R::amp
+                && U1::hour + SIGN * U2::hour == R::hour && U1::degree + SIGN * U2::degree == R::degree
+        };
+    };
+
+    //U1 * U2 == R without rescaling
+    template<class U1, class U2, class R>
+    struct IsProduct {
+        enum { ok = CheckDimension<U1, U2, 1, R>::ok && U1::scale * U2::scale == R::scale };
+    };
+
+    //the smallest unsigned type that holds MAX
+    template<bool fits16> struct Width { typedef uint32_t type; };
+    template<> struct Width<true> { typedef uint16_t type; };
+
+    //a value with its unit, MAX is the largest value the caller guarantees (checked at compile time only)
+    template<class U, uint32_t MAX = 0xffff>
+    struct Value {
+        typedef U unit;
+        static const uint32_t max = MAX;
+        AnalogInputs::ValueType value;
+    };
+
+    template<class U, uint32_t MAX>
+    inline Value<U, MAX> value(AnalogInputs::ValueType v) {
+        Value<U, MAX> r;
+        r.value = v;
+        return r;
+    }
+    template<class U>
+    inline Value<U> value(AnalogInputs::ValueType v) {
+        return value<U, 0xffff>(v);
+    }
+
+    //R = a * b, rejects unit mismatches and results that may not fit into a ValueType
+    template<class R, class A, class B>
+    struct Product {
+        typedef typename A::unit UA;
+        typedef typename B::unit UB;
+        static const uint32_t scale = UA::scale * UB::scale;
+        static const uint32_t divider = scale >= R::scale ? scale / R::scale : 1;
+        static const uint32_t multiplier = scale >= R::scale ? 1 : R::scale / scale;
+        static const uint32_t max = A::max * B::max;
+        typedef typename Width<max * multiplier <= 0xffff>::type type;
+
+        //each assert in its own scope: the C++98 STATIC_ASSERT is a typedef
+        static void check() {
+            { STATIC_ASSERT_MSG((CheckDimension<UA, UB, 1, R>::ok), "unit mismatch"); }
+            { STATIC_ASSERT_MSG(scale % R::scale == 0 || R::scale % scale == 0, "inexact unit conversion"); }
+            { STATIC_ASSERT_MSG(A::max <= 0xffffffff / B::max, "intermediate overflow"); }
+            { STATIC_ASSERT_MSG(max / divider <= 0xffff / multiplier, "result overflow"); }
+        }
+    };
+
+    template<class R, class A, class B>
+    inline AnalogInputs::ValueType multiply(A a, B b) {
+        typedef Product<R, A, B> P;
+        P::check();
+        typename P::type r = a.value;
+        r *= b.value;
+        r *= P::multiplier;
+        r /= P::divider;
+        return r;
+    }
+
+};
+
+#endif /* UNITS_H_ */
@@ -20,6 +20,7 @@
 #include "Hardware.h"
 #include "AnalogInputs.h"
 #include "memory.h"
+#include "PrintNumber.h"
 
 void callVoidMethod_P(const VoidMethod * method)
 {
@@ -85,6 +86,21 @@ uint8_t countBits(uint16_t v)
     return bits;
 }
 
+//256*ln(x/y)
+uint16_t ln256(uint32_t x, uint32_t y)
+{
+    //ln(x) = log2(x)*ln(2), log2 with linear interpolation between powers of 2
+    uint16_t log2 = 0;
+    if(y == 0 || x <= y)
+        return 0;
+    while(x >= 2*y) {
+        y *= 2;
+        log2 += 256;
+    }
+    log2 += (x - y) * 256 / y;
+    return uint32_t(log2) * 177 / 256; // ln(2)*256 = 177
+}
+
 uint8_t digits(uint16_t x)
 {
     return digits((int32_t)x);
@@ -93,15 +109,12 @@ uint8_t digits(uint16_t x)
 uint8_t digits(int32_t x)
 {
     uint8_t retu = 0;
+    uint32_t u = x;
     if(x < 0) {
         retu++;
-        x = -x;
+        u = -u;
     }
-    if(x == 0)
-        retu=1;
-    for(;x!=0; x/=10)
-        retu++;
-    return retu;
+    return retu + PrintNumber::digits(u);
 }
 
 void change0ToMax(uint16_t *v, int dir, uint8_t max)
@@ -56,6 +56,7 @@ uint8_t digits(int32_t x);
 uint8_t digits(uint16_t x);
 int8_t sign(int16_t x);
 uint8_t countBits(uint16_t v);
+uint16_t ln256(uint32_t x, uint32_t y);
 
 void change0ToInfSmart(uint16_t *v, int dir);
 void changeMinToMaxSmart(uint16_t *v, int dir, uint16_t min, uint16_t max);
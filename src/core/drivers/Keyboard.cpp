@@ -20,26 +20,30 @@
 #include "Buzzer.h"
 #include "memory.h"
 #include "Utils.h"
+#include "atomic.h"
+#include "Profile.h"
 //#define ENABLE_DEBUG
 #include "debug.h"
 
-//delay until next key read, must not be smaller than 7ms (see: atmeag32/generic/200W/AnalogInputsADC.cpp:adc_keyboard_)
+//key read period, must not be smaller than 7ms (see: atmeag32/generic/200W/AnalogInputsADC.cpp:adc_keyboard_)
 #define BUTTON_DELAY                 7
 #define BUTTON_DEBOUNCE_COUNT        3
+#define BUTTON_INTERRUPT_INTERVAL    (BUTTON_DELAY*1000/TIMER_INTERRUPT_PERIOD_MICROSECONDS)
 
 
 namespace Keyboard {
     static const uint8_t stateDelay[]   PROGMEM = {   25,    12,     3,     1,     1,     1};
     static const uint8_t stayInState[]  PROGMEM = {    1,     3,    24,    71,   142,     1};
     static const uint8_t speedFactor[]  PROGMEM = {    1,     1,     1,     2,    10,    30};
-           //timing (assuming screen is not redrawn)
+           //timing (assuming events are consumed in time)
            //change per:                           175ms,  84ms,  21ms,   7ms,   7ms,   7ms
            //inState:                              175ms, 252ms, 504ms, 497ms, 994ms, for ever
            //changes/second (with speed factor):     5.7,  11.9,  47.6, 285.7,  1428,  4285
 
-    uint8_t last_key_ = BUTTON_NONE;
+    //interrupt state
+    volatile uint8_t last_key_ = BUTTON_NONE;
     uint8_t debounce_ = 0;
-
+    uint8_t delay_ = 0;
     uint8_t inState_ = 0;
 
     //state_ - "key pressed" state
@@ -47,8 +51,16 @@ namespace Keyboard {
     //state_ == n - key is pressed and hold
     uint8_t state_ = 0;
 
+    //event queue, written only by the interrupt (head_), read only by the main loop (tail_)
+    Event queue_[KEYBOARD_QUEUE_SIZE];
+    volatile uint8_t head_ = 0;
+    volatile uint8_t tail_ = 0;
+
+    //state of the last consumed event
+    uint8_t eventState_ = 0;
+
     bool isLongPressTime() {
-        return state_ > 2;
+        return eventState_ > 2;
     }
 
     uint8_t getLast() {
@@ -56,49 +68,119 @@ namespace Keyboard {
     }
 
     uint8_t getSpeedFactor() {
-        return pgm::read(&speedFactor[state_]);
+        return pgm::read(&speedFactor[eventState_]);
     }
-}
 
-uint8_t Keyboard::getPressedWithDelay()
-{
-    uint8_t key, delay = 0, currentStateDelay;
+    inline uint8_t next(uint8_t i) {
+        if(++i >= KEYBOARD_QUEUE_SIZE) i = 0;
+        return i;
+    }
 
-    pgm::read(currentStateDelay, &stateDelay[state_]);
+    void push(uint8_t key, uint8_t type) {
+        uint8_t h = head_;
+        uint8_t n = next(h);
+        if(n == tail_) {
+            //queue full, drop the event
+            return;
+        }
+        queue_[h].key = key;
+        queue_[h].type = type;
+        queue_[h].state = state_;
+        queue_[h].time = Time::getMilisecondsU16();
+        head_ = n;
+    }
+}
 
-    do {
-        Time::delayDoIdle(BUTTON_DELAY);
-        key = hardware::getKeyPressed();
-        if(last_key_ != key) {
-            if(debounce_ == 0) {
-                //key changed
-                last_key_ = key;
-                state_ = 0;
+void Keyboard::doInterrupt()
+{
+    static uint8_t interval = BUTTON_INTERRUPT_INTERVAL;
+    if(--interval) return;
+    interval = BUTTON_INTERRUPT_INTERVAL;
+
+    uint8_t key = hardware::getKeyPressed();
+    if(last_key_ != key) {
+        if(debounce_ == 0) {
+            //key changed
+            last_key_ = key;
+            state_ = 0;
+            inState_ = 0;
+            delay_ = 0;
+            push(key, key == BUTTON_NONE ? Release : Press);
+            return;
+        }
+        debounce_--;
+    } else {
+        debounce_++;
+    }
+    if(debounce_ > BUTTON_DEBOUNCE_COUNT) {
+        debounce_ = BUTTON_DEBOUNCE_COUNT;
+        if(key == BUTTON_NONE) return;
+
+        if(++delay_ <= pgm::read(&stateDelay[state_]))
+            return;
+        delay_ = 0;
+
+        //change state if necessary
+        uint8_t type = Repeat;
+        if(state_ < sizeOfArray(stateDelay) - 1) {
+            inState_++;
+            if(inState_ >= pgm::read(&stayInState[state_])) {
+                state_ ++;
                 inState_ = 0;
-                if(key != BUTTON_NONE) {
-                    Buzzer::soundKeyboard();
-                }
-                return key;
+                if(state_ == 3) type = LongPress;
             }
-            debounce_--;
-        } else {
-            debounce_++;
-        }
-        if(debounce_ > BUTTON_DEBOUNCE_COUNT) {
-            debounce_ = BUTTON_DEBOUNCE_COUNT;
-            delay++;
         }
-    } while (delay <= currentStateDelay);
+        push(key, type);
+    }
+}
 
-    //change state if necessary
-    if(state_ < sizeOfArray(stateDelay) - 1 && key != BUTTON_NONE) {
-        inState_++;
-        if(inState_ >= pgm::read(&stayInState[state_])) {
-            state_ ++;
-            inState_ = 0;
+bool Keyboard::getEvent(Event &e)
+{
+    bool empty;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        uint8_t t = tail_;
+        empty = t == head_;
+        if(!empty) {
+            e = queue_[t];
+            tail_ = next(t);
         }
     }
+    if(empty)
+        return false;
 
-    return key;
+    eventState_ = e.state;
+    if(e.type == Press) {
+        Buzzer::soundKeyboard();
+    }
+    LogDebug("key:", e.key, " type:", e.type, " time:", e.time);
+    return true;
+}
+
+uint8_t Keyboard::getPressed()
+{
+    Event e;
+    if(getEvent(e) && e.type != Release)
+        return e.key;
+    return BUTTON_NONE;
 }
 
+uint8_t Keyboard::getPressedWithDelay()
+{
+    PROFILE_ZONE(Keyboard);
+    Event e;
+    uint16_t start = Time::getMilisecondsU16();
+    const uint16_t timeout = pgm::read(&stateDelay[0]) * BUTTON_DELAY;
+
+    do {
+        if(getEvent(e)) {
+            if(e.type == Release)
+                return BUTTON_NONE;
+            return e.key;
+        }
+        Time::doIdle();
+        //a held key produces Repeat events, don't report BUTTON_NONE meanwhile
+    } while (last_key_ != BUTTON_NONE || Time::diffU16(start, Time::getMilisecondsU16()) < timeout);
+
+    eventState_ = 0;
+    return BUTTON_NONE;
+}
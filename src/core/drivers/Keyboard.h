@@ -27,11 +27,34 @@
 #define BUTTON_INC          4
 #define BUTTON_START        8
 
+#define KEYBOARD_QUEUE_SIZE 8
+
 namespace Keyboard {
+    enum EventType {Press, Repeat, LongPress, Release};
+    struct Event {
+        uint8_t key;
+        uint8_t type;
+        //acceleration state (see speedFactor)
+        uint8_t state;
+        uint16_t time; //Time::getMilisecondsU16()
+    };
+
+    //debounced key
     uint8_t  getLast();
+    //speed factor and long press of the last consumed event
     uint8_t getSpeedFactor();
-    uint8_t  getPressedWithDelay();
     bool isLongPressTime();
+
+    //non blocking
+    bool getEvent(Event &e);
+    //key of the next Press/Repeat/LongPress event or BUTTON_NONE
+    uint8_t  getPressed();
+    //waits for the next event, returns BUTTON_NONE when no key
+    //is pressed for a while
+    uint8_t  getPressedWithDelay();
+
+    //private - called from Time::callback
+    void doInterrupt();
 };
 
 
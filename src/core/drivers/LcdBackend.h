@@ -0,0 +1,39 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef LCDBACKEND_H_
+#define LCDBACKEND_H_
+
+#include "Hardware.h"
+
+//display backend, a text mode driver with the LiquidCrystal interface:
+//  init(), begin(cols, lines), clear(), setCursor(x, y), print(char),
+//  createChar(slot, bitmap), flush(), doInterrupt() (from Time::callback)
+//a graphic display driver renders a LCD_COLUMNS x LCD_LINES char grid,
+//the target selects it with:
+//  #define LCD_BACKEND_HEADER "MyDisplay.h"
+//  #define LCD_BACKEND MyDisplay
+#ifdef LCD_BACKEND_HEADER
+#include LCD_BACKEND_HEADER
+#else
+#include "LiquidCrystal.h"
+#define LCD_BACKEND LiquidCrystal
+#endif
+
+namespace LcdBackend = LCD_BACKEND;
+
+#endif /* LCDBACKEND_H_ */
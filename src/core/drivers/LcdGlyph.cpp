@@ -0,0 +1,85 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <string.h>
+#include "LcdGlyph.h"
+#include "LcdBackend.h"
+
+namespace LcdGlyph {
+
+    uint8_t bitmap_[LCD_GLYPH_SLOTS][LCD_GLYPH_HEIGHT];
+    //frame in which the slot was last used
+    uint8_t slotFrame_[LCD_GLYPH_SLOTS];
+    //slots with a valid bitmap
+    uint8_t loaded_;
+    uint8_t frame_;
+
+    void beginFrame() {
+        frame_++;
+    }
+
+    uint8_t get(const uint8_t bitmap[LCD_GLYPH_HEIGHT], uint8_t fallback) {
+        uint8_t slot = LCD_GLYPH_SLOTS;
+        uint8_t maxAge = 0;
+        for(uint8_t i = 0; i < LCD_GLYPH_SLOTS; i++) {
+            if(!(loaded_ & (1<<i))) {
+                slot = i;
+                maxAge = 255;
+                continue;
+            }
+            if(memcmp(bitmap_[i], bitmap, LCD_GLYPH_HEIGHT) == 0) {
+                slotFrame_[i] = frame_;
+                return LCD_GLYPH_FIRST + i;
+            }
+            //least recently used slot, not used in this frame
+            uint8_t age = frame_ - slotFrame_[i];
+            if(age > maxAge) {
+                maxAge = age;
+                slot = i;
+            }
+        }
+        if(slot == LCD_GLYPH_SLOTS)
+            return fallback;
+
+        memcpy(bitmap_[slot], bitmap, LCD_GLYPH_HEIGHT);
+        slotFrame_[slot] = frame_;
+        loaded_ |= 1<<slot;
+        LcdBackend::createChar(LCD_GLYPH_FIRST + slot, bitmap_[slot]);
+        return LCD_GLYPH_FIRST + slot;
+    }
+
+    uint8_t getBar(uint8_t level, uint8_t fallback) {
+        uint8_t bitmap[LCD_GLYPH_HEIGHT];
+        for(uint8_t i = 0; i < LCD_GLYPH_HEIGHT; i++) {
+            bitmap[i] = i + level >= LCD_GLYPH_HEIGHT ? 0b01110 : 0;
+        }
+        return get(bitmap, fallback);
+    }
+
+    uint8_t getColumns(const uint8_t levels[LCD_GLYPH_WIDTH], uint8_t fallback) {
+        uint8_t bitmap[LCD_GLYPH_HEIGHT];
+        memset(bitmap, 0, LCD_GLYPH_HEIGHT);
+        for(uint8_t c = 0; c < LCD_GLYPH_WIDTH; c++) {
+            uint8_t bit = 1 << (LCD_GLYPH_WIDTH - 1 - c);
+            for(uint8_t i = LCD_GLYPH_HEIGHT - levels[c]; i < LCD_GLYPH_HEIGHT; i++) {
+                bitmap[i] |= bit;
+            }
+        }
+        return get(bitmap, fallback);
+    }
+
+} // namespace LcdGlyph
@@ -0,0 +1,48 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef LCDGLYPH_H_
+#define LCDGLYPH_H_
+
+#include <stdint.h>
+
+//CGRAM slots 0..2 are the static battery chars (see lcdCreateCGRam)
+#define LCD_GLYPH_FIRST     3
+#define LCD_GLYPH_SLOTS     (8 - LCD_GLYPH_FIRST)
+#define LCD_GLYPH_HEIGHT    8
+#define LCD_GLYPH_WIDTH     5
+
+//dynamic custom characters, a slot is reused when the same bitmap is
+//requested again and only changed slots are uploaded to the LCD
+//
+//usage (one frame = one full page draw):
+//  LcdGlyph::beginFrame();
+//  c = LcdGlyph::getBar(level, ':');   - before lcdSetCursor, uploading
+//                                        moves the LCD address to CGRAM
+//  lcdSetCursor0_0(); ... lcdPrintChar(c);
+namespace LcdGlyph {
+    void beginFrame();
+    //returns the char of the glyph or fallback if all slots are used in this frame
+    uint8_t get(const uint8_t bitmap[LCD_GLYPH_HEIGHT], uint8_t fallback);
+
+    //vertical bar, level 0..LCD_GLYPH_HEIGHT
+    uint8_t getBar(uint8_t level, uint8_t fallback);
+    //LCD_GLYPH_WIDTH columns, levels 0..LCD_GLYPH_HEIGHT
+    uint8_t getColumns(const uint8_t levels[LCD_GLYPH_WIDTH], uint8_t fallback);
+};
+
+#endif /* LCDGLYPH_H_ */
@@ -0,0 +1,52 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "memory.h"
+#include "LcdLayout.h"
+#include "LcdPrint.h"
+
+void LcdLayout::display(const Field *fields)
+{
+    uint8_t x = 0, y = 0;
+    Field f;
+    lcdSetCursor0_0();
+    while(true) {
+        pgm::read(f, fields++);
+        if(f.print == NULL)
+            break;
+
+        uint8_t width = f.width;
+        if(width == LCD_LAYOUT_FILL)
+            width = LCD_COLUMNS - x;
+        if(x + width > LCD_COLUMNS || width == 0) {
+            lcdPrintSpaces(LCD_COLUMNS - x);
+            x = 0;
+            if(++y >= LCD_LINES)
+                return;
+            lcdSetCursor(0, y);
+            if(f.width == LCD_LAYOUT_FILL)
+                width = LCD_COLUMNS;
+        }
+        f.print(f.arg, width);
+        x += width;
+    }
+    lcdPrintSpaces(LCD_COLUMNS - x);
+    while(++y < LCD_LINES) {
+        lcdSetCursor(0, y);
+        lcdPrintSpaces();
+    }
+}
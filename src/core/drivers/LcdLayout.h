@@ -0,0 +1,48 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef LCDLAYOUT_H_
+#define LCDLAYOUT_H_
+
+#include <stdint.h>
+#include "Hardware.h"
+
+//display geometry classes, the page layouts are selected at compile time
+#if LCD_COLUMNS >= 20 && LCD_LINES >= 4
+#define LCD_LAYOUT_20x4
+#endif
+
+//field width: the rest of the line
+#define LCD_LAYOUT_FILL     0
+
+namespace LcdLayout {
+    //prints exactly width chars
+    typedef void (*FieldMethod)(uint8_t arg, int8_t width);
+
+    struct Field {
+        FieldMethod print;
+        uint8_t arg;
+        uint8_t width;
+    };
+
+    //fields (PROGMEM, terminated by print == NULL) flow left to right,
+    //a field that does not fit starts on the next line,
+    //the unused part of the display is cleared
+    void display(const Field *fields);
+};
+
+#endif /* LCDLAYOUT_H_ */
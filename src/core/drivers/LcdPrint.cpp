@@ -18,35 +18,30 @@
 #include "LcdPrint.h"
 #include "Hardware.h"
 #include "memory.h"
-#include "LiquidCrystal.h"
+#include "LcdBackend.h"
+#include "PrintNumber.h"
 
 using namespace AnalogInputs;
 
 char* printLong(int32_t value, char * buf) {
-    char * end;
-    if (value < 0) {
-        *(buf++)='-';
-        value = -value;
-    }
-    buf += digits((int32_t)value);
-    *buf = 0;
-    end = buf;
-    buf--;
-    do {
-        *buf = (value%10) + '0';
-        value /= 10;
-        buf--;
-    } while(value);
-    return end;
+    return PrintNumber::printLong(value, buf);
 }
 
-void lcdSetCursor(uint8_t x, uint8_t y) { LiquidCrystal::setCursor(x, y); }
+#if LCD_LINES > 2
+//on 4 line displays the DDRAM of line 0 continues in line 2,
+//chars past the end of a line are dropped
+uint8_t lcdColumn_;
+void lcdSetCursor(uint8_t x, uint8_t y) { lcdColumn_ = x; LcdBackend::setCursor(x, y); }
+void lcdClear() { lcdColumn_ = 0; LcdBackend::clear(); }
+#else
+void lcdSetCursor(uint8_t x, uint8_t y) { LcdBackend::setCursor(x, y); }
+void lcdClear() { LcdBackend::clear(); }
+#endif
 void lcdSetCursor0_0() { lcdSetCursor(0,0); }
 void lcdSetCursor0_1() { lcdSetCursor(0,1); }
-void lcdClear() { LiquidCrystal::clear(); }
 
 int8_t lcdPrintSpace1() {   return lcdPrintSpaces(1); }
-int8_t lcdPrintSpaces() {   return lcdPrintSpaces(16);}
+int8_t lcdPrintSpaces() {   return lcdPrintSpaces(LCD_COLUMNS);}
 int8_t lcdPrintSpaces(int8_t n)
 {
     return lcdPrintChar(' ', n);
@@ -118,51 +113,40 @@ void lcdPrintR_P(const char *str, int8_t size)
 }
 
 
-static uint16_t div10(uint16_t div) {
-    if(div <= 100)
-        return 100;
-    return 1000;
-}
-
+//div must be a power of 10 (see unitsInfo)
 void lcdPrintValue_(uint16_t x, int8_t dig, uint16_t div, bool mili, bool minus)
 {
     char buf[12];
-    char *end, *dot_char;
-    int32_t t;
+    char *end = buf;
 
-    uint8_t size;
+    if(minus && x) {
+        *(end++) = '-';
+    }
 
     if(mili) {
-        t = x;
-        t *= 1000;
-        t /= div;
-        if(minus) {
-            t = -t;
+        uint32_t t = x;
+        if(div != 1000) {
+            //div divides 1000: a 16 bit division, no 32 bit one
+            uint16_t factor = 1000 / div;
+            t *= factor;
         }
-        size = digits(t) + 1;
+        uint8_t size = PrintNumber::digits(t) + (end - buf) + 1;
         if(size <= dig) {
-            dig--;
-            lcdPrintLong(t, dig);
+            PrintNumber::printUInt(t, end);
+            lcdPrintR(buf, dig - 1);
             lcdPrintChar('m');
             return;
         }
     }
 
-    end = buf;
-
-    t = x / div;
-    if(minus) {
-        *(end++) = '-';
-    }
-    end = printLong(t, end);
-    if(div > 1 && end - buf < dig -1) {
-        dot_char = end;
-        t = x % div;
-        t += div;
-        t *= div10(div);
-        t /= div;
-        printLong(t, end);
-        *dot_char = '.';
+    uint8_t decimals = PrintNumber::getDecimals(div);
+    end = PrintNumber::printFixed(x, decimals, end);
+    if(decimals) {
+        char *dot_char = end - decimals - 1;
+        if(dot_char - buf >= dig - 1) {
+            //no place for the fractional part
+            *dot_char = 0;
+        }
     }
 
     lcdPrintR(buf, dig);
@@ -197,7 +181,12 @@ void lcdPrintChar(char c)
     if(c == '\n') {
         lcdSetCursor0_1();
     } else {
-        LiquidCrystal::print(c);
+#if LCD_LINES > 2
+        if(lcdColumn_ >= LCD_COLUMNS)
+            return;
+        lcdColumn_++;
+#endif
+        LcdBackend::print(c);
     }
 }
 
@@ -352,7 +341,7 @@ void lcdCreateCGRam()
    CGRAM[5] = 0b10001;
    CGRAM[6] = 0b10001;
    CGRAM[7] = 0b11111;
-   LiquidCrystal::createChar(0, CGRAM); //battery empty
+   LcdBackend::createChar(0, CGRAM); //battery empty
 
    CGRAM[0] = 0b01110;
    CGRAM[1] = 0b11111;
@@ -362,7 +351,7 @@ void lcdCreateCGRam()
    CGRAM[5] = 0b11111;
    CGRAM[6] = 0b11111;
    CGRAM[7] = 0b11111;
-   LiquidCrystal::createChar(1, CGRAM); //battery half full
+   LcdBackend::createChar(1, CGRAM); //battery half full
 
    CGRAM[0] = 0b01110;
    CGRAM[1] = 0b11111;
@@ -372,7 +361,7 @@ void lcdCreateCGRam()
    CGRAM[5] = 0b11111;
    CGRAM[6] = 0b11111;
    CGRAM[7] = 0b11111;
-   LiquidCrystal::createChar(2, CGRAM); //battery full
+   LcdBackend::createChar(2, CGRAM); //battery full
 }
 #endif
 
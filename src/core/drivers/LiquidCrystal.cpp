@@ -23,14 +23,22 @@
 #include "IO.h"
 #include "Utils.h"
 #include "Hardware.h"
+#include "Time.h"
+#include "atomic.h"
 
 #ifndef DummyLiquidCrystal_h
 
+#if defined(ENABLE_LCD_ASYNC) && !defined(LCD_ENABLE_8BITMODE)
+#define LCD_ASYNC
+#endif
+
 namespace LiquidCrystal {
     void send(uint8_t, uint8_t);
     void write4bits(uint8_t);
     void write8bits(uint8_t);
+    void writeNibble(uint8_t);
     void pulseEnable();
+    void pulse();
 
     uint8_t _displayfunction;
     uint8_t _displaycontrol;
@@ -39,6 +47,57 @@ namespace LiquidCrystal {
     uint8_t _initialized;
 
     uint8_t _numlines, _currline;
+
+#ifdef LCD_ASYNC
+#define LCD_QUEUE_SIZE          48
+#define LCD_QUEUE_RS            1
+#define LCD_QUEUE_LONG          2
+//clear and home need > 1.52ms
+#define LCD_LONG_COMMAND_TICKS  4
+
+    struct QueueEntry {
+        uint8_t value;
+        uint8_t flags;
+    };
+
+    //written by the main loop (head_), drained by the timer interrupt (tail_)
+    volatile QueueEntry queue_[LCD_QUEUE_SIZE];
+    volatile uint8_t head_ = 0;
+    volatile uint8_t tail_ = 0;
+    //the queue is used once the timer interrupt runs,
+    //LCD initialization (hardware::initialize) is synchronous
+    volatile bool async_ = false;
+    bool lowNibble_ = false;
+    uint8_t wait_ = 0;
+
+    inline uint8_t next(uint8_t i) {
+        if(++i >= LCD_QUEUE_SIZE) i = 0;
+        return i;
+    }
+
+    //with the interrupts disabled the queue is written out synchronously
+    bool isAsync() {
+        if(!async_)
+            return false;
+        if(interruptsEnabled())
+            return true;
+        while(head_ != tail_) {
+            doInterrupt();
+            Utils::delayMicroseconds(TIMER_INTERRUPT_PERIOD_MICROSECONDS);
+        }
+        return false;
+    }
+
+    void push(uint8_t value, uint8_t flags) {
+        uint8_t h = head_;
+        uint8_t n = next(h);
+        //queue full - wait for the interrupt
+        while(n == tail_) {}
+        queue_[h].value = value;
+        queue_[h].flags = flags;
+        head_ = n;
+    }
+#endif
 }
 
 
@@ -165,24 +224,38 @@ void LiquidCrystal::begin(uint8_t cols, uint8_t lines, uint8_t dotsize) {
 /********** high level commands, for the user! */
 void LiquidCrystal::clear()
 {
+#ifdef LCD_ASYNC
+  if(isAsync()) {
+    push(LCD_CLEARDISPLAY, LCD_QUEUE_LONG);
+    return;
+  }
+#endif
   command(LCD_CLEARDISPLAY);  // clear display, set cursor position to zero
   Utils::delayMicroseconds(2000);  // this command takes a long time!
 }
 
 void LiquidCrystal::home()
 {
+#ifdef LCD_ASYNC
+  if(isAsync()) {
+    push(LCD_RETURNHOME, LCD_QUEUE_LONG);
+    return;
+  }
+#endif
   command(LCD_RETURNHOME);  // set cursor position to zero
   Utils::delayMicroseconds(2000);  // this command takes a long time!
 }
 
 void LiquidCrystal::setCursor(uint8_t col, uint8_t row)
 {
-  int row_offsets[] = { 0x00, 0x40, 0x14, 0x54 };
   if ( row >= _numlines ) {
     row = _numlines-1;    // we count rows starting w/0
   }
+  // lines 2 and 3 continue lines 0 and 1 (0x00, 0x40, cols, 0x40 + cols)
+  if (row & 1) col += 0x40;
+  if (row & 2) col += LCD_COLUMNS;
 
-  command(LCD_SETDDRAMADDR | (col + row_offsets[row]));
+  command(LCD_SETDDRAMADDR | col);
 }
 
 // Turn the display on/off (quickly)
@@ -272,6 +345,12 @@ inline uint8_t LiquidCrystal::write(uint8_t value) {
 
 // write either command or data, with automatic 4/8-bit selection
 void LiquidCrystal::send(uint8_t value, uint8_t mode) {
+#ifdef LCD_ASYNC
+  if(isAsync()) {
+    push(value, mode ? LCD_QUEUE_RS : 0);
+    return;
+  }
+#endif
   IO::digitalWrite(LCD_RS_PIN, mode);
 
   // if there is a RW pin indicated, set it low to Write
@@ -287,21 +366,30 @@ void LiquidCrystal::send(uint8_t value, uint8_t mode) {
 #endif //LCD_ENABLE_8BITMODE
 }
 
-void LiquidCrystal::pulseEnable(void) {
+void LiquidCrystal::pulse(void) {
   IO::digitalWrite(LCD_ENABLE_PIN, LOW);
   Utils::delayMicroseconds(1);
   IO::digitalWrite(LCD_ENABLE_PIN, HIGH);
   Utils::delayMicroseconds(1);    // enable pulse must be >450ns
   IO::digitalWrite(LCD_ENABLE_PIN, LOW);
+}
+
+void LiquidCrystal::pulseEnable(void) {
+  pulse();
   Utils::delayMicroseconds(100);   // commands need > 37us to settle
 }
 
-void LiquidCrystal::write4bits(uint8_t value) {
+void LiquidCrystal::writeNibble(uint8_t value) {
   IO::digitalWrite(LCD_D0_PIN, value & 1);
   IO::digitalWrite(LCD_D1_PIN, value & 2);
   IO::digitalWrite(LCD_D2_PIN, value & 4);
   IO::digitalWrite(LCD_D3_PIN, value & 8);
-  pulseEnable();
+  pulse();
+}
+
+void LiquidCrystal::write4bits(uint8_t value) {
+  writeNibble(value);
+  Utils::delayMicroseconds(100);   // commands need > 37us to settle
 }
 
 void LiquidCrystal::write8bits(uint8_t value) {
@@ -336,6 +424,45 @@ uint8_t LiquidCrystal::print(char c)
   return write((uint8_t) c);
 }
 
+void LiquidCrystal::flush()
+{
+#ifdef LCD_ASYNC
+  if(isAsync()) {
+    while(head_ != tail_) {}
+  }
+#endif
+}
+
+//the timer interrupt period (500us) is longer than any
+//command execution time except clear and home
+void LiquidCrystal::doInterrupt()
+{
+#ifdef LCD_ASYNC
+  async_ = true;
+  if(wait_) {
+    wait_--;
+    return;
+  }
+  uint8_t t = tail_;
+  if(t == head_)
+    return;
+
+  uint8_t value = queue_[t].value;
+  uint8_t flags = queue_[t].flags;
+  if(!lowNibble_) {
+    IO::digitalWrite(LCD_RS_PIN, flags & LCD_QUEUE_RS);
+    writeNibble(value >> 4);
+    lowNibble_ = true;
+  } else {
+    writeNibble(value);
+    lowNibble_ = false;
+    if(flags & LCD_QUEUE_LONG)
+      wait_ = LCD_LONG_COMMAND_TICKS;
+    tail_ = next(t);
+  }
+#endif
+}
+
 uint8_t LiquidCrystal::write(const uint8_t *buffer, uint8_t size)
 {
   uint8_t n = 0;
@@ -97,6 +97,11 @@ namespace LiquidCrystal {
   uint8_t print(char c);
   uint8_t print(const char buffer[]);
 
+  //waits until the output queue is empty (ENABLE_LCD_ASYNC)
+  void flush();
+  //private - called from Time::callback
+  void doInterrupt();
+
 } //namespace LiquidCrystal
 
 #endif
@@ -0,0 +1,129 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "PrintNumber.h"
+#include "memory.h"
+
+namespace PrintNumber {
+    const uint32_t pow10_32[] PROGMEM = {
+        1000000000, 100000000, 10000000, 1000000, 100000, 10000
+    };
+    //values <= UINT16_MAX are printed with 16 bit arithmetic only
+    const uint16_t pow10_16[] PROGMEM = {
+        10000, 1000, 100, 10
+    };
+    const uint8_t pow10_32_size = sizeof(pow10_32)/sizeof(pow10_32[0]);
+    const uint8_t pow10_16_size = sizeof(pow10_16)/sizeof(pow10_16[0]);
+}
+
+uint8_t PrintNumber::digits(uint32_t x)
+{
+    uint8_t retu = 10;
+    uint8_t i = 0;
+    if(x > UINT16_MAX) {
+        for(; i < pow10_32_size; i++, retu--) {
+            if(x >= pgm::read(&pow10_32[i]))
+                return retu;
+        }
+        //x < 10000
+        i = 1;
+    } else {
+        retu = 5;
+    }
+    uint16_t y = x;
+    for(; i < pow10_16_size; i++, retu--) {
+        if(y >= pgm::read(&pow10_16[i]))
+            return retu;
+    }
+    return 1;
+}
+
+char *PrintNumber::printUInt(uint32_t x, char *buf, uint8_t minDigits)
+{
+    //position of the current digit, counted from the right
+    uint8_t pos = 10;
+    uint8_t i = 0;
+    if(x > UINT16_MAX || minDigits > 5) {
+        for(; i < pow10_32_size; i++, pos--) {
+            uint32_t p = pgm::read(&pow10_32[i]);
+            char d = '0';
+            while(x >= p) {
+                x -= p;
+                d++;
+            }
+            if(d != '0' || pos <= minDigits) {
+                *buf++ = d;
+                minDigits = pos;
+            }
+        }
+        //x < 10000
+        i = 1;
+    } else {
+        pos = 5;
+    }
+    uint16_t y = x;
+    for(; i < pow10_16_size; i++, pos--) {
+        uint16_t p = pgm::read(&pow10_16[i]);
+        char d = '0';
+        while(y >= p) {
+            y -= p;
+            d++;
+        }
+        if(d != '0' || pos <= minDigits) {
+            *buf++ = d;
+            minDigits = pos;
+        }
+    }
+    *buf++ = '0' + y;
+    *buf = 0;
+    return buf;
+}
+char *PrintNumber::printLong(int32_t x, char *buf)
+{
+    uint32_t u = x;
+    if(x < 0) {
+        *buf++ = '-';
+        u = -u;
+    }
+    return printUInt(u, buf);
+}
+
+char *PrintNumber::printFixed(uint32_t x, uint8_t decimals, char *buf)
+{
+    char *end = printUInt(x, buf, decimals + 1);
+    if(decimals) {
+        //insert the decimal point
+        char *dot = end - decimals;
+        for(char *p = end; p >= dot; p--) {
+            *(p+1) = *p;
+        }
+        *dot = '.';
+        end++;
+    }
+    return end;
+}
+
+uint8_t PrintNumber::getDecimals(uint16_t div)
+{
+    uint8_t decimals = 0;
+    uint16_t p = 1;
+    while(p < div) {
+        p *= 10;
+        decimals++;
+    }
+    return decimals;
+}
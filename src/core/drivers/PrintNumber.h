@@ -0,0 +1,36 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef PRINTNUMBER_H_
+#define PRINTNUMBER_H_
+
+#include <stdint.h>
+
+//number formatting without divisions (32 bit division is a libgcc call on AVR),
+//the digits are found by subtracting powers of ten
+namespace PrintNumber {
+    uint8_t digits(uint32_t x);
+    //prints at least minDigits digits (zero padded), returns the end of the string
+    char *printUInt(uint32_t x, char *buf, uint8_t minDigits = 1);
+    char *printLong(int32_t x, char *buf);
+    //fixed point: x = 1234, decimals = 3 -> "1.234"
+    char *printFixed(uint32_t x, uint8_t decimals, char *buf);
+    //div = 10^decimals (see ANALOG_* units)
+    uint8_t getDecimals(uint16_t div);
+};
+
+#endif /* PRINTNUMBER_H_ */
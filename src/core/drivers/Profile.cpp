@@ -0,0 +1,45 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "Profile.h"
+
+#ifdef ENABLE_PROFILE
+
+namespace Profile {
+    Stat stat[LAST_ZONE];
+
+    void store(uint8_t zone, uint32_t start) {
+        uint32_t t = Time::getMicroseconds() - start;
+        Stat &s = stat[zone];
+        if(s.count == 0xffff)
+            return;
+        if(s.count == 0 || t < s.min) s.min = t;
+        if(t > s.max) s.max = t;
+        s.total += t;
+        s.count++;
+    }
+
+    void reset() {
+        for(uint8_t i = 0; i < LAST_ZONE; i++) {
+            stat[i].count = 0;
+            stat[i].total = 0;
+            stat[i].max = 0;
+        }
+    }
+}
+
+#endif //ENABLE_PROFILE
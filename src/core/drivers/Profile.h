@@ -0,0 +1,68 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+#include <stdint.h>
+#include "Hardware.h"
+#include "Time.h"
+
+//main loop profiling (ENABLE_PROFILE in GlobalConfig.h):
+//PROFILE_ZONE(id) measures the rest of the enclosing block,
+//the statistics are sent in the SerialLog channel 4, see utils/profileReport
+namespace Profile {
+    //keep in sync with utils/profileReport/profileReport.py
+    enum Zone {
+        ZoneStrategy,           //Strategy::strategy->doStrategy
+        ZoneScreen,             //Screen::doStrategy
+        ZoneSerialLog,          //SerialLog::send
+        ZoneAnalogInputs,       //AnalogInputs::finalizeFullMeasurement
+        ZoneKeyboard,           //Keyboard::getPressedWithDelay
+        LAST_ZONE
+    };
+
+    //durations in microseconds, since the last reset()
+    struct Stat {
+        uint16_t count;
+        uint32_t total;
+        uint32_t min;
+        uint32_t max;
+    };
+
+    extern Stat stat[LAST_ZONE];
+
+    void store(uint8_t zone, uint32_t start);
+    void reset();
+
+    class Scope {
+    public:
+        Scope(uint8_t zone) : zone_(zone), start_(Time::getMicroseconds()) {}
+        ~Scope() { store(zone_, start_); }
+    private:
+        uint8_t zone_;
+        uint32_t start_;
+    };
+};
+
+#ifdef ENABLE_PROFILE
+#define PROFILE_ZONE(id)    Profile::Scope profileZone_(Profile::Zone ## id)
+#else
+#define PROFILE_ZONE(id)
+#endif
+
+#endif /* PROFILE_H_ */
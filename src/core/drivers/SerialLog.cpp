@@ -27,6 +27,8 @@
 #include "SerialLog.h"
 #include "AnalogInputsPrivate.h"
 #include "Balancer.h"
+#include "DelayStrategy.h"
+#include "Profile.h"
 
 #ifdef ENABLE_SERIAL_LOG
 #include "Serial.h"
@@ -116,6 +118,7 @@ void send()
 {
     if(state == Off)
         return;
+    PROFILE_ZONE(SerialLog);
 
     currentTime = Time::getMiliseconds();
 
@@ -259,6 +262,8 @@ void sendChannel1()
     printD();
     printLong(Monitor::getETATime());
     printD();
+    printUInt(DelayStrategy::getRelaxationTau());
+    printD();
 
     sendEnd();
 }
@@ -298,6 +303,26 @@ void sendChannel3()
 }
 
 
+#ifdef ENABLE_PROFILE
+void sendChannel4()
+{
+    sendHeader(4);
+    for(uint8_t i = 0; i < Profile::LAST_ZONE; i++) {
+        const Profile::Stat &s = Profile::stat[i];
+        printUInt(s.count);
+        printD();
+        printLong(s.total);
+        printD();
+        printLong(s.count ? s.min : 0);
+        printD();
+        printLong(s.max);
+        printD();
+    }
+    sendEnd();
+    Profile::reset();
+}
+#endif
+
 void sendTime()
 {
     int uart = settings.UART;
@@ -315,6 +340,11 @@ void sendTime()
     if(uart > Settings::Debug)
         sendChannel3();
 
+#ifdef ENABLE_PROFILE
+    if(uart > Settings::Normal)
+        sendChannel4();
+#endif
+
 }
 
 } //namespace SerialLog
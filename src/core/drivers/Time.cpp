@@ -22,6 +22,10 @@
 #include "Screen.h"
 #include "SerialLog.h"
 #include "AnalogInputsPrivate.h"
+#include "Balancer.h"
+#include "Thermal.h"
+#include "Keyboard.h"
+#include "LcdBackend.h"
 #include "atomic.h"
 
 //#define ENABLE_DEBUG
@@ -54,6 +58,14 @@ namespace Time {
     void callback() {
         static uint8_t slowInterval = TIMER_SLOW_INTERRUPT_INTERVAL;
         Time::doInterrupt();
+        Balancer::doInterrupt();
+        Keyboard::doInterrupt();
+#ifdef ENABLE_LCD_ASYNC
+        LcdBackend::doInterrupt();
+#endif
+#ifdef ENABLE_THERMAL_FAN
+        Thermal::doInterrupt();
+#endif
         if(--slowInterval == 0){
             slowInterval = TIMER_SLOW_INTERRUPT_INTERVAL;
             AnalogInputs::doSlowInterrupt();
@@ -33,11 +33,15 @@ namespace Time {
     uint16_t getSecondsU16();
     uint32_t getSeconds();
     uint16_t getMinutesU16();
+    //timer counter resolution (4us on atmega32), used by Profile.h
+    uint32_t getMicroseconds();
     void delay(uint16_t ms);
 
     //warning: this method runs stuff in background,
     //delay may take significantly longer than "ms"
     void delayDoIdle(uint16_t ms);
+    //runs the background stuff once (see delayDoIdle)
+    void doIdle();
 
     inline uint16_t diffU16(uint16_t start, uint16_t end) {
         return end - start;
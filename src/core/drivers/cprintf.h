@@ -36,6 +36,7 @@
 #define CP_TYPE_PROCENTAGE      CP_TYPE_ANALOG(AnalogInputs::Procent)
 #define CP_TYPE_A               CP_TYPE_ANALOG(AnalogInputs::Current)
 #define CP_TYPE_W               CP_TYPE_ANALOG(AnalogInputs::Power)
+#define CP_TYPE_OHM             CP_TYPE_ANALOG(AnalogInputs::Resistance)
 #define CP_TYPE_TEMP_MINUT      CP_TYPE_ANALOG(AnalogInputs::TemperatureMinutes)
 #define CP_TYPE_CHARGE          CP_TYPE_ANALOG(AnalogInputs::Charge)
 #define CP_TYPE_CHARGE_TIME     CP_TYPE_ANALOG(AnalogInputs::TimeLimitMinutes)
@@ -2,6 +2,10 @@
 set(CORE_SOURCE
     cprintf.cpp  Blink.cpp  Buzzer.cpp  Keyboard.h     LcdPrint.h    LiquidCrystal.h    PolarityCheck.h    SerialLog.h      Time.cpp
     cprintf.h    Blink.h    Buzzer.h    Keyboard.cpp   LcdPrint.cpp  LiquidCrystal.cpp  PolarityCheck.cpp  SerialLog.cpp    StackInfo.h  Time.h
+    PrintNumber.cpp  PrintNumber.h
+    LcdGlyph.cpp  LcdGlyph.h
+    LcdBackend.h  LcdLayout.cpp  LcdLayout.h
+    Profile.cpp  Profile.h
 )
 
 CHEALI_ADD("CORE_SOURCE_FILES" "${CORE_SOURCE}")
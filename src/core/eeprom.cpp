@@ -31,6 +31,9 @@
 
 namespace eeprom {
     Data data EEMEM;
+#ifdef E2END
+    STATIC_ASSERT_MSG(sizeof(Data) <= E2END + 1, "eeprom::Data too big, see SEQUENCER_PROGRAM_SIZE");
+#endif
 
     bool testOrRestore(uint16_t * adr, uint16_t version, bool restore) {
         uint8_t trials = EEPROM_READ_TRIALS;
@@ -66,6 +69,9 @@ namespace eeprom {
         if(restore & EEPROM_RESTORE_SETTINGS)   Settings::restoreDefault();
         if(restoreSettingsCRC(false)) test |= EEPROM_RESTORE_SETTINGS;
 
+        if(restore & EEPROM_RESTORE_SEQUENCE)   Sequencer::restoreDefault();
+        if(restoreSequenceCRC(false)) test |= EEPROM_RESTORE_SEQUENCE;
+
         return test;
     }
 
@@ -74,6 +80,7 @@ namespace eeprom {
         if(what & EEPROM_RESTORE_MAGIC_NUMBER)  what |= EEPROM_RESTORE_CALIBRATION;
         if(what & EEPROM_RESTORE_CALIBRATION)   what |= EEPROM_RESTORE_PROGRAM_DATA;
         if(what & EEPROM_RESTORE_PROGRAM_DATA)  what |= EEPROM_RESTORE_SETTINGS;
+        if(what & EEPROM_RESTORE_SETTINGS)      what |= EEPROM_RESTORE_SEQUENCE;
 
         Screen::displayResettingEeprom();
         uint8_t after = testOrRestore(what);
@@ -133,6 +140,10 @@ namespace eeprom {
     bool restoreSettingsCRC(bool restore) {
         return testOrRestoreCRC((uint8_t*)&data.settings, sizeof(data.settings), restore);
     }
+
+    bool restoreSequenceCRC(bool restore) {
+        return testOrRestoreCRC((uint8_t*)&data.sequence, sizeof(data.sequence), restore);
+    }
 #endif
 
 }
@@ -21,6 +21,7 @@
 #include "AnalogInputs.h"
 #include "ProgramData.h"
 #include "Settings.h"
+#include "Sequencer.h"
 #include "cpu.h"
 
 #define EEPROM_MAGIC_STRING_LEN 4
@@ -29,6 +30,7 @@
 #define EEPROM_RESTORE_CALIBRATION          2
 #define EEPROM_RESTORE_PROGRAM_DATA         4
 #define EEPROM_RESTORE_SETTINGS             8
+#define EEPROM_RESTORE_SEQUENCE             16
 
 
 namespace eeprom {
@@ -48,6 +50,9 @@ namespace eeprom {
 
         Settings settings;
         uint16_t settingsCRC;
+
+        Sequencer::Data sequence;
+        uint16_t sequenceCRC;
     } CHEALI_EEPROM_PACKED;
 
     extern Data data;
@@ -56,10 +61,12 @@ namespace eeprom {
     bool restoreCalibrationCRC(bool restore = true);
     bool restoreProgramDataCRC(bool restore = true);
     bool restoreSettingsCRC(bool restore = true);
+    bool restoreSequenceCRC(bool restore = true);
 #else
     inline bool restoreCalibrationCRC(bool restore = true)  { return false; }
     inline bool restoreProgramDataCRC(bool restore = true)  { return false; }
     inline bool restoreSettingsCRC(bool restore = true)     { return false; }
+    inline bool restoreSequenceCRC(bool restore = true)     { return false; }
 #endif
 
 #ifdef ENABLE_EEPROM_RESTORE_DEFAULT
@@ -82,7 +82,55 @@ namespace EditMenu {
     }
 
 
+    //what the visible lines show, an edit (and its callback) can change
+    //other items, only the changed lines are repainted
+    struct LineInfo {
+        uint8_t index;
+        uint16_t value;
+    };
+
+    void getLineInfo(LineInfo &info, uint8_t item)
+    {
+        info.index = 0xff;
+        info.value = 0;
+        if(item >= Menu::size_)
+            return;
+        info.index = getSelectedIndexOrSize(item);
+        uint8_t type = pgm::read(&staticEditData_[info.index].print.type);
+        uint16_t * valuePtr = getEditAddress(item);
+        if(type != CP_TYPE_METHOD && valuePtr) {
+            info.value = *valuePtr;
+        } else {
+            //unknown, always repaint
+            info.index = 0xfe;
+        }
+    }
+
+    void doEditItem(uint8_t item, uint8_t key);
+
     void editItem(uint8_t item, uint8_t key)
+    {
+        LineInfo before[LCD_LINES], after;
+        uint8_t size = Menu::size_;
+        for(uint8_t i = 0; i < LCD_LINES; i++) {
+            getLineInfo(before[i], Menu::begin_ + i);
+        }
+
+        doEditItem(item, key);
+
+        if(size != Menu::size_) {
+            Menu::renderAll();
+            return;
+        }
+        for(uint8_t i = 0; i < LCD_LINES; i++) {
+            getLineInfo(after, Menu::begin_ + i);
+            if(after.index == 0xfe || after.index != before[i].index || after.value != before[i].value) {
+                Menu::setRender(Menu::begin_ + i);
+            }
+        }
+    }
+
+    void doEditItem(uint8_t item, uint8_t key)
     {
         uint16_t * valuePtr = getEditAddress(item);
         uint8_t index = getSelectedIndexOrSize(item);
@@ -28,7 +28,8 @@ namespace Menu {
     uint8_t index_;
     uint8_t begin_;
     uint8_t size_;
-    bool render_;
+    //lines to repaint, bit n = line n
+    uint8_t render_;
     bool waitRelease_;
     PrintMethod printMethod_;
     EditMethod editMethod_;
@@ -45,7 +46,7 @@ namespace Menu {
         index_ = 0;
         begin_ = 0;
         size_ = size;
-        render_ = true;
+        render_ = MENU_RENDER_ALL;
         waitRelease_ = true;
     }
 
@@ -99,33 +100,48 @@ namespace Menu {
         }
     }
 
+    void setRender(uint8_t item) {
+        uint8_t line = item - begin_;
+        if(line < LCD_LINES) render_ |= 1 << line;
+    }
+
+    void renderAll() {
+        render_ = MENU_RENDER_ALL;
+    }
+
     void display() {
+        uint8_t begin = begin_;
         checkBegin();
+        if(begin != begin_) render_ = MENU_RENDER_ALL;
         for(uint8_t i = begin_; i < begin_ + LCD_LINES; i++) {
+            if(!(render_ & (1 << (i - begin_)))) continue;
             lcdSetCursor(0, i - begin_);
             lcdPrintChar(i == index_ ? '>' : ' ');
             if(i < size_) printMethod_(i);
             lcdPrintSpaces();
         }
-        render_ = false;
+        render_ = 0;
     }
 
     uint8_t run_() {
         uint8_t button = Keyboard::getPressedWithDelay();
 
         if(PolarityCheck::runReversedPolarityInfo()) {
-            render_ = true;
+            render_ = MENU_RENDER_ALL;
             return POLARITY_CHECK_REVERSED_POLARITY;
         }
 
         switch (button) {
         case BUTTON_INC:
+            //only the old and the new cursor line
+            setRender(index_);
             incIndex();
-            render_ = true;
+            setRender(index_);
             break;
         case BUTTON_DEC:
+            setRender(index_);
             decIndex();
-            render_ = true;
+            setRender(index_);
             break;
         }
 
@@ -137,7 +153,7 @@ namespace Menu {
 
     int8_t run(bool alwaysRefresh) {
         uint8_t key;
-        render_ = true;
+        render_ = MENU_RENDER_ALL;
         do {
             key = run_();
             if(key == BUTTON_NONE) waitRelease_ = false;
@@ -146,7 +162,7 @@ namespace Menu {
                 waitRelease_ = true;
                 return getIndex();
             }
-            if(alwaysRefresh) render_ = true;
+            if(alwaysRefresh) render_ = MENU_RENDER_ALL;
         } while(key != BUTTON_STOP || waitRelease_);
         return MENU_EXIT;
     }
@@ -155,18 +171,18 @@ namespace Menu {
     {
         Blink::startBlinkOff(getIndex());
         uint8_t key;
-        render_ = true;
+        setRender(getIndex());
         do {
             key =  Keyboard::getPressedWithDelay();
             if(key == BUTTON_DEC || key == BUTTON_INC) {
                 editMethod_(getIndex(), key);
                 Blink::startBlinkOn(getIndex());
-                render_ = true;
+                setRender(getIndex());
             } else if(key == BUTTON_STOP || key == BUTTON_START) {
                 break;
             }
             if(Blink::getBlinkChanged())
-                render_ = true;
+                setRender(getIndex());
             if(render_)
                 display();
             Blink::incBlinkTime();
@@ -174,7 +190,7 @@ namespace Menu {
 
         Blink::stopBlink();
         waitRelease_ = true;
-        render_ = true;
+        setRender(getIndex());
         return key == BUTTON_START;
     }
 
@@ -22,6 +22,7 @@
 #include "PolarityCheck.h"
 
 #define MENU_EXIT   -1
+#define MENU_RENDER_ALL 0xff
 
 namespace Menu {
 
@@ -46,6 +47,10 @@ namespace Menu {
     int8_t run(bool alwaysRefresh = false);
     bool runEdit();
 
+    //repaint the line of the item (if visible) on the next display
+    void setRender(uint8_t item);
+    void renderAll();
+
     inline uint8_t getIndex()             { return index_; }
     inline void setIndex(uint8_t index)   {  index_ = index; }
 
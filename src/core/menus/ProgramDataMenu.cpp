@@ -37,6 +37,8 @@ namespace ProgramDataMenu {
 #define COND_enableT        256
 #define COND_enable_dV      512
 #define COND_enable_dT      1024
+#define COND_dischargeP     2048
+#define COND_dischargeR     4096
 #define COND_advanced       32768
 #define ADV(x)              (COND_advanced + COND_ ## x)
 
@@ -63,6 +65,11 @@ uint16_t getSelector() {
         if(isNiXX() && battery.enable_deltaV) {
             result += COND_enable_dV;
         }
+        if(getDischargeMode() == DischargePower) {
+            result += COND_dischargeP;
+        } else if(getDischargeMode() == DischargeResistance) {
+            result += COND_dischargeR;
+        }
         if(settings.menuType) {
             result += COND_advanced;
         }
@@ -77,6 +84,15 @@ void changeVoltage(int dir)
 
 const cprintf::ArrayData batteryTypeData  PROGMEM = {batteryString, &battery.type};
 
+#ifdef ENABLE_POWER_DISCHARGE
+const char * const dischargeModeString[] PROGMEM = {
+        string_dischargeCurrent,
+        string_dischargePower,
+        string_dischargeResistance,
+};
+const cprintf::ArrayData dischargeModeData PROGMEM = {dischargeModeString, &battery.dischargeMode};
+#endif
+
 
 const AnalogInputs::ValueType Tmin = (Settings::TempDifference/ANALOG_CELCIUS(1))*ANALOG_CELCIUS(1) + ANALOG_CELCIUS(1);
 const AnalogInputs::ValueType Tmax = ANALOG_CELCIUS(99);
@@ -104,6 +120,11 @@ const EditMenu::StaticEditData editData[] PROGMEM = {
 {string_minIc,          ADV(LiXX_NiZn_Pb_Unkn), BATTERY(A, minIc),                  {CE_STEP_TYPE_SMART, ANALOG_AMP(0.001), MAX_CHARGE_I}},
 {string_Id,             COND_BATTERY,       BATTERY(A, Id),                         {CE_STEP_TYPE_SMART, ANALOG_AMP(0.001), MAX_DISCHARGE_I}},
 {string_minId,          ADV(BATTERY),       BATTERY(A, minId),                      {CE_STEP_TYPE_SMART, ANALOG_AMP(0.001), MAX_DISCHARGE_I}},
+#ifdef ENABLE_POWER_DISCHARGE
+{string_dischargeMode,  ADV(LiXX_NiZn_Pb_Unkn), EDIT_STRING_ARRAY(dischargeModeData),   {1, 0, LAST_DISCHARGE_MODE-1}},
+{string_dischargeP,     COND_dischargeP,    BATTERY(W, dischargeValue),             {CE_STEP_TYPE_SMART, ANALOG_WATT(0.1), MAX_DISCHARGE_P}},
+{string_dischargeR,     COND_dischargeR,    BATTERY(OHM, dischargeValue),           {CE_STEP_TYPE_SMART, ANALOG_OHM(0.1), ANALOG_OHM(65.0)}},
+#endif
 {string_balancErr,      ADV(LiXX_NiZn),     BATTERY(SIGNED_mV, balancerError),      {ANALOG_VOLT(0.001), ANALOG_VOLT(0.003), ANALOG_VOLT(0.200)}},
 
 {string_enabledV,       COND_NiXX,          BATTERY(ON_OFF, enable_deltaV),         {1, 0, 1}},
@@ -134,6 +155,8 @@ const EditMenu::StaticEditData editData[] PROGMEM = {
             ProgramData::changedIc();
         } else if(value == &ProgramData::battery.Id) {
             ProgramData::changedId();
+        } else if(value == &ProgramData::battery.dischargeMode) {
+            ProgramData::changedDischargeMode();
         }
         ProgramData::check();
         EditMenu::setSelector(getSelector());
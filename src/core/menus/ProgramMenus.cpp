@@ -49,6 +49,12 @@ namespace ProgramMenus {
             Program::DischargeChargeCycle,
 #endif
             Program::CapacityCheck,
+#ifdef ENABLE_PROGRAM_MEASURE_R
+            Program::MeasureResistance,
+#endif
+#ifdef ENABLE_PROGRAM_SEQUENCE
+            Program::Sequence,
+#endif
             Program::EditBattery,
     };
 
@@ -62,6 +68,12 @@ namespace ProgramMenus {
             Program::DischargeChargeCycle,
 #endif
             Program::CapacityCheck,
+#ifdef ENABLE_PROGRAM_MEASURE_R
+            Program::MeasureResistance,
+#endif
+#ifdef ENABLE_PROGRAM_SEQUENCE
+            Program::Sequence,
+#endif
             Program::EditBattery,
     };
 
@@ -70,6 +82,12 @@ namespace ProgramMenus {
             Program::Discharge,
             Program::DischargeChargeCycle,
             Program::CapacityCheck,
+#ifdef ENABLE_PROGRAM_MEASURE_R
+            Program::MeasureResistance,
+#endif
+#ifdef ENABLE_PROGRAM_SEQUENCE
+            Program::Sequence,
+#endif
             Program::EditBattery,
     };
 
@@ -79,6 +97,12 @@ namespace ProgramMenus {
             Program::FastCharge,
             Program::DischargeChargeCycle,
             Program::CapacityCheck,
+#ifdef ENABLE_PROGRAM_MEASURE_R
+            Program::MeasureResistance,
+#endif
+#ifdef ENABLE_PROGRAM_SEQUENCE
+            Program::Sequence,
+#endif
             Program::EditBattery,
     };
 
@@ -98,24 +122,27 @@ namespace ProgramMenus {
             string_storageAndBalance,
             string_dcCycle,
             string_capacityCheck,
+            string_measureResistance,
+            string_sequence,
             string_editBattery,
     };
 
+// BatteryClass -> program menu
+    const Program::ProgramType * const programMenus[] PROGMEM = {
+/*ClassNiXX*/       programNiXXMenu,
+/*ClassPb*/         programPbMenu,
+/*ClassLiXX*/       programLiXXMenu,
+/*ClassNiZn*/       programNiZnMenu,
+/*ClassUnknown*/    programPbMenu,
+/*ClassLED*/        programLEDMenu,
+    };
+
     inline const Program::ProgramType * getSelectProgramMenu() {
-        STATIC_ASSERT(ProgramData::LAST_BATTERY_CLASS == 6);
+        STATIC_ASSERT(sizeOfArray(programMenus) == ProgramData::LAST_BATTERY_CLASS);
 
-        ProgramData::BatteryClass bc = ProgramData::getBatteryClass();
         if(ProgramData::battery.type == ProgramData::NoneBatteryType)
             return programNoneMenu;
-        if(bc == ProgramData::ClassNiZn)
-            return programNiZnMenu;
-        if(bc == ProgramData::ClassLiXX)
-            return programLiXXMenu;
-        if(bc == ProgramData::ClassNiXX)
-            return programNiXXMenu;
-        if(bc == ProgramData::ClassLED)
-            return programLEDMenu;
-        else return programPbMenu;
+        return pgm::read(&programMenus[ProgramData::getBatteryClass()]);
     }
 
     static uint8_t countElements() {
@@ -24,11 +24,13 @@
 #include "Hardware.h"
 #include "Program.h"
 #include "DelayStrategy.h"
+#include "ResistanceStrategy.h"
 #include "Version.h"
 #include "ProgramDCcycle.h"
 #include "Monitor.h"
 #include "PolarityCheck.h"
 #include "Utils.h"
+#include "Profile.h"
 
 #include "ScreenPages.h"
 
@@ -37,9 +39,15 @@ namespace Screen {
     uint8_t pageNr_;
     uint8_t keyboardButton;
 
-    //see PAGE_PROGRAM
-    //see PAGE_BATTERY
-    STATIC_ASSERT_MSG(ProgramData::LAST_BATTERY_CLASS == 6 && Program::LAST_PROGRAM_TYPE == 9 + 2, "see ScreenPages.h");
+    //the page is redrawn only when render_ is set or its refresh policy allows it
+    bool render_;
+    uint16_t blinkTime_;
+    uint16_t refreshTime_;
+    uint16_t measurement_;
+
+    //see PAGE_PROGRAM, PAGE_BATTERY and the condition bits in ScreenPages.h
+    STATIC_ASSERT_MSG(PAGE_PROGRAM(Program::LAST_PROGRAM_TYPE - 2) <= PAGE_BATTERY(0)
+            && PAGE_BATTERY(ProgramData::LAST_BATTERY_CLASS) <= PAGE_BALANCE_PORT, "see ScreenPages.h");
 
     uint32_t getConditions() {
         uint32_t c = 0;
@@ -52,28 +60,81 @@ namespace Screen {
         return c;
     }
 
-    VoidMethod getPage(uint8_t page) {
-        uint8_t i = 0;
-        Pages::PageInfo info;
+    void changePage() {
+        render_ = true;
+#if LCD_LINES > 2
+        //the 2 line pages do not clear the other lines
+        lcdClear();
+#endif
+    }
+
+    //indexes of the pages enabled by condition_, see Pages::pageInfo
+    const uint8_t pagesSize = sizeOfArray(Pages::pageInfo) - 1;
+    uint8_t pages_[pagesSize];
+    uint8_t pagesCount_;
+    uint32_t condition_;
+
+    void updatePages() {
         uint32_t condition = getConditions();
-        bool ok;
-        page++;
-        do {
-            info = pgm::read(&Pages::pageInfo[i]);
-            ok = ((info.conditionEnable & condition) > 0) && ((info.conditionDisable & condition) == 0);
-            if(ok) {
-                page--;
+        if(condition == condition_ && pagesCount_)
+            return;
+        condition_ = condition;
+        changePage();
+        pagesCount_ = 0;
+        for(uint8_t i = 0; i < pagesSize; i++) {
+            Pages::PageInfo info;
+            pgm::read(info, &Pages::pageInfo[i]);
+            if((info.conditionEnable & condition) && (info.conditionDisable & condition) == 0) {
+                pages_[pagesCount_++] = i;
             }
-            i++;
-        } while(page);
-        return info.displayMethod;
+        }
+        if(pageNr_ >= pagesCount_) {
+            pageNr_ = pagesCount_ - 1;
+        }
     }
 
-    void displayPage() {
+    VoidMethod getPage(uint8_t page) {
+        return pgm::read(&Pages::pageInfo[pages_[page]].displayMethod);
+    }
+
+    bool doBlink() {
+        uint16_t time = Time::getMilisecondsU16();
+        if(Time::diffU16(blinkTime_, time) < SCREEN_BLINK_PERIOD_MS)
+            return false;
+        blinkTime_ = time;
         Screen::Cycle::storeCycleHistoryInfo();
+#ifdef ENABLE_LCD_GLYPHS
+        Screen::Graph::storeHistory();
+#endif
         Blink::incBlinkTime();
+        return true;
+    }
 
-        getPage(pageNr_)();
+    void displayPage(bool blink) {
+        updatePages();
+
+        uint16_t refresh = pgm::read(&Pages::pageInfo[pages_[pageNr_]].refresh);
+        uint16_t period = refresh & PAGE_REFRESH_MS_MASK;
+        uint16_t measurement = AnalogInputs::getFullMeasurementCount();
+        uint16_t time = Time::getMilisecondsU16();
+
+        if((refresh & PAGE_REFRESH_BLINK) && blink)
+            render_ = true;
+        if((refresh & PAGE_REFRESH_MEASUREMENT) && measurement != measurement_)
+            render_ = true;
+        if(period && Time::diffU16(refreshTime_, time) >= period) {
+            //keep the phase, a 1s page shows every second
+            refreshTime_ += period;
+            if(Time::diffU16(refreshTime_, time) >= period)
+                refreshTime_ = time;
+            render_ = true;
+        }
+
+        if(render_) {
+            render_ = false;
+            measurement_ = measurement;
+            getPage(pageNr_)();
+        }
     }
 
     void displayAnimation();
@@ -84,21 +145,28 @@ namespace Screen {
 
 void Screen::doStrategy()
 {
-    if(!PolarityCheck::runReversedPolarityInfo()) {
-        Screen::displayPage();
-    }
+    PROFILE_ZONE(Screen);
+    bool blink = doBlink();
 
-    if(keyboardButton == BUTTON_INC && getPage(pageNr_ + 1) != NULL ) {
+    if(keyboardButton == BUTTON_INC && pageNr_ + 1 < pagesCount_) {
 #ifdef ENABLE_SCREEN_ANIMATION
         Screen::displayAnimation();
 #endif
         pageNr_++;
+        changePage();
     }
     if(keyboardButton == BUTTON_DEC && pageNr_ > 0) {
 #ifdef ENABLE_SCREEN_ANIMATION
         Screen::displayAnimation();
 #endif
         pageNr_--;
+        changePage();
+    }
+
+    if(PolarityCheck::runReversedPolarityInfo()) {
+        render_ = true;
+    } else {
+        Screen::displayPage(blink);
     }
 }
 
@@ -106,7 +174,13 @@ void Screen::powerOn()
 {
     Blink::startBlinkOn(0);
     pageNr_ = 0;
+    pagesCount_ = 0;
+    render_ = true;
+    blinkTime_ = refreshTime_ = Time::getMilisecondsU16();
     Screen::Cycle::resetCycleHistory();
+#ifdef ENABLE_LCD_GLYPHS
+    Screen::Graph::resetHistory();
+#endif
 }
 
 void Screen::powerOff() {}
@@ -150,6 +224,20 @@ namespace Screen {
 void Screen::displayScreenProgramCompleted()
 {
     screenEnd(PSTR("complete:"));
+    if(Program::stopReason == NULL) {
+        lcdSetCursor0_1();
+#ifdef ENABLE_PROGRAM_MEASURE_R
+        if(Strategy::strategy == &ResistanceStrategy::vtable) {
+            //the measured battery resistance
+            lcdPrint_P(PSTR("batt. R="));
+            lcdPrintResistance(TheveninMethod::getReadableBattRth(), 8);
+            return;
+        }
+#endif
+        //energy and charge to the cutoff
+        AnalogInputs::printRealValue(AnalogInputs::Eout, 8);
+        AnalogInputs::printRealValue(AnalogInputs::Cout, 8);
+    }
 }
 
 void Screen::displayMonitorError()
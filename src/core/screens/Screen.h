@@ -38,7 +38,16 @@
 #define PAGE_START_INFO             (1L<<30)
 #define PAGE_BALANCE_PORT           (1L<<29)
 #define PAGE_PROGRAM(program)       (1<<(program))
-#define PAGE_BATTERY(_class)        ((1<<9)<<(_class))
+#define PAGE_BATTERY(_class)        ((1L<<11)<<(_class))
+
+//page refresh policy, can be combined
+#define PAGE_REFRESH_MEASUREMENT    0x8000
+#define PAGE_REFRESH_BLINK          0x4000
+#define PAGE_REFRESH_MS(ms)         (ms)
+#define PAGE_REFRESH_MS_MASK        0x3fff
+
+//blink tick period
+#define SCREEN_BLINK_PERIOD_MS      175
 
 namespace Screen {
 
@@ -30,6 +30,8 @@
 #include "PolarityCheck.h"
 #include "ScreenBalancer.h"
 #include "Balancer.h"
+#include "LcdGlyph.h"
+#include "LcdLayout.h"
 
 namespace Screen { namespace Balancer {
 
@@ -45,27 +47,27 @@ namespace Screen { namespace Balancer {
         return TheveninMethod::getReadableRthCell(cell);
     }
 
-    void printBalancer(uint8_t cell, AnalogInputs::Type type) {
-        if(cell < MAX_BALANCE_CELLS) {
-            lcdPrintDigit(cell+1);
-            lcdPrintChar(':');
-
-            if(AnalogInputs::isConnected(AnalogInputs::Name(AnalogInputs::Vb1+cell))) {
-                lcdPrintAnalog(getBalanceValue(cell, type), 6, type);
-            } else {
-                lcdPrint_P(PSTR("  --  "));
+    char getSeparator(uint8_t cell, AnalogInputs::Type type)
+    {
+#ifdef ENABLE_LCD_GLYPHS
+        //cell voltage bar: Vd_per_cell .. Vc_per_cell
+        if(type == AnalogInputs::Voltage && AnalogInputs::isConnected(AnalogInputs::Name(AnalogInputs::Vb1+cell))) {
+            AnalogInputs::ValueType v = ::Balancer::getPresumedV(cell);
+            AnalogInputs::ValueType vd = ProgramData::battery.Vd_per_cell;
+            AnalogInputs::ValueType vc = ProgramData::battery.Vc_per_cell;
+            uint8_t level = 1;
+            if(vc > vd && v > vd) {
+                if(v >= vc) level = LCD_GLYPH_HEIGHT;
+                else level += uint32_t(v - vd) * (LCD_GLYPH_HEIGHT - 1) / (vc - vd);
             }
+            return LcdGlyph::getBar(level, ':');
         }
+#endif
+        return ':';
     }
 
-    void displayBalanceInfo(uint8_t from, AnalogInputs::Type type)
+    char getStatusChar()
     {
-        lcdSetCursor0_0();
-
-#ifdef ENABLE_SCREEN_KNIGHTRIDEREFFECT
-        knightRiderCounter += knightRiderDir;
-        if (knightRiderCounter==0 || knightRiderCounter>4) knightRiderDir=-knightRiderDir;
-#endif
         char c = ' ';
         if(!::Balancer::isWorking()) {
             if(!::Balancer::isStable())
@@ -76,9 +78,37 @@ namespace Screen { namespace Balancer {
             else
                 c = 'b';
         }
+        return c;
+    }
+
+    char getCellChar(uint8_t i)
+    {
+        uint16_t cell = 1 << i;
+        if(!(AnalogInputs::connectedBalancePortCells & cell))
+            return ' ';
+        if(i == ::Balancer::minCell)
+            return SCREEN_EMPTY_CELL_CHAR; //lowest cell
+        if(::Balancer::balance & cell) {
+            if (Blink::blinkTime_ & 1) {
+                return SCREEN_FULL_CELL_CHAR; //flash full/empty cells
+            } else {
+                return SCREEN_EMPTY_CELL_CHAR; //flash full/empty cells
+            }
+        }
+        return SCREEN_AVR_CELL_CHAR; //average cells
+    }
+
+    void printStatus(uint8_t, int8_t width)
+    {
+#ifdef ENABLE_SCREEN_KNIGHTRIDEREFFECT
+        knightRiderCounter += knightRiderDir;
+        if (knightRiderCounter==0 || knightRiderCounter>4) knightRiderDir=-knightRiderDir;
+#endif
+        char c = getStatusChar();
 
         if (::Balancer::balance == 0) {
             lcdPrintChar(c);
+            width--;
 #ifdef ENABLE_SCREEN_KNIGHTRIDEREFFECT
             char knightRiderArrow;
             if (knightRiderDir > 0) knightRiderArrow='>'; else knightRiderArrow='<';
@@ -87,45 +117,87 @@ namespace Screen { namespace Balancer {
                     if (knightRiderCounter==i) lcdPrintChar(knightRiderArrow);
                     else lcdPrintChar(' ');
                 }
-                lcdPrintChar(' ');
-            } else {
-                lcdPrintSpaces(7);
+                width -= 6;
             }
-#else
-        lcdPrintSpaces(7);
 #endif
         } else {
-            uint16_t cell = 1;
             for(uint8_t i = 0; i < MAX_BALANCE_CELLS; i++) {
-                if(AnalogInputs::connectedBalancePortCells & cell) {
-                    if(i == ::Balancer::minCell) {
-                        c = SCREEN_EMPTY_CELL_CHAR; //lowest cell
-                    } else {
-                        if(::Balancer::balance & cell) {
-                            if (Blink::blinkTime_ & 1) {
-                                c = SCREEN_FULL_CELL_CHAR; //flash full/empty cells
-                            } else {
-                                c = SCREEN_EMPTY_CELL_CHAR; //flash full/empty cells
-                            }
-                        } else {
-                         c = SCREEN_AVR_CELL_CHAR; //average cells
-                        }
-                    }
-                } else {
-                    c = ' ';
-                }
-                lcdPrintChar(c);
-                cell <<= 1;
+                lcdPrintChar(getCellChar(i));
             }
-            lcdPrintSpaces(8 - MAX_BALANCE_CELLS);
+            width -= MAX_BALANCE_CELLS;
         }
-        printBalancer(from++, type);
-        lcdPrintSpaces();
+        lcdPrintSpaces(width);
+    }
 
-        lcdSetCursor0_1();
-        printBalancer(from++, type);
-        printBalancer(from++, type);
-        lcdPrintSpaces();
+    //"1:3.998V", on 20x4 with the balancer state of the cell: "*1:3.998V "
+    void printCell(uint8_t cell, int8_t width, AnalogInputs::Type type)
+    {
+        if(cell >= MAX_BALANCE_CELLS) {
+            lcdPrintSpaces(width);
+            return;
+        }
+#ifdef LCD_LAYOUT_20x4
+        if(::Balancer::balance == 0) {
+            lcdPrintChar(cell == 0 ? getStatusChar() : ' ');
+        } else {
+            lcdPrintChar(getCellChar(cell));
+        }
+        width--;
+#endif
+        lcdPrintDigit(cell+1);
+        lcdPrintChar(getSeparator(cell, type));
+
+        if(AnalogInputs::isConnected(AnalogInputs::Name(AnalogInputs::Vb1+cell))) {
+            lcdPrintAnalog(getBalanceValue(cell, type), 6, type);
+        } else {
+            lcdPrint_P(PSTR("  --  "));
+        }
+        lcdPrintSpaces(width - 8);
+    }
+
+    void printVoltage(uint8_t cell, int8_t width)       { printCell(cell, width, AnalogInputs::Voltage); }
+    void printResistance(uint8_t cell, int8_t width)    { printCell(cell, width, AnalogInputs::Resistance); }
+
+#ifdef LCD_LAYOUT_20x4
+    //all cells on one page, 2 cells per line
+#define BALANCER_PAGE(name, method, from)                       \
+    const LcdLayout::Field name[] PROGMEM = {                   \
+        {method, 0, 10}, {method, 1, 10},                       \
+        {method, 2, 10}, {method, 3, 10},                       \
+        {method, 4, 10}, {method, 5, 10},                       \
+        BALANCER_PORTS_GT_6({method, 6, 10}, {method, 7, 10},)  \
+        {NULL, 0, 0}                                            \
+    };
+#else
+    //status + 3 cells
+#define BALANCER_PAGE(name, method, from)                       \
+    const LcdLayout::Field name[] PROGMEM = {                   \
+        {printStatus, 0, 8}, {method, from, 8},                 \
+        {method, from + 1, 8}, {method, from + 2, 8},           \
+        {NULL, 0, 0}                                            \
+    };
+#endif
+
+    BALANCER_PAGE(voltage1_3,       printVoltage,       0)
+    BALANCER_PAGE(resistance1_3,    printResistance,    0)
+#ifndef LCD_LAYOUT_20x4
+    BALANCER_PAGE(voltage4_6,       printVoltage,       3)
+    BALANCER_PAGE(resistance4_6,    printResistance,    3)
+BALANCER_PORTS_GT_6(
+    BALANCER_PAGE(voltage7_9,       printVoltage,       6)
+    BALANCER_PAGE(resistance7_9,    printResistance,    6))
+#endif
+
+    void displayBalanceInfo(const LcdLayout::Field *fields, uint8_t from, AnalogInputs::Type type)
+    {
+#ifdef ENABLE_LCD_GLYPHS
+        //upload the bar glyphs before drawing (see LcdGlyph.h)
+        LcdGlyph::beginFrame();
+        for(uint8_t i = from; i < from + SCREEN_BALANCER_CELLS_PER_PAGE && i < MAX_BALANCE_CELLS; i++) {
+            getSeparator(i, type);
+        }
+#endif
+        LcdLayout::display(fields);
     }
 
 }// namespcae Balancer
@@ -133,22 +205,25 @@ namespace Screen { namespace Balancer {
 
 
 void Screen::Balancer::displayVoltage1_3() {
-    displayBalanceInfo(0, AnalogInputs::Voltage);
-}
-void Screen::Balancer::displayVoltage4_6() {
-    displayBalanceInfo(3, AnalogInputs::Voltage);
+    displayBalanceInfo(voltage1_3, 0, AnalogInputs::Voltage);
 }
-void Screen::Balancer::displayVoltage7_9() {
-    displayBalanceInfo(6, AnalogInputs::Voltage);
+void Screen::Balancer::displayResistance1_3() {
+    displayBalanceInfo(resistance1_3, 0, AnalogInputs::Resistance);
 }
 
-void Screen::Balancer::displayResistance1_3() {
-    displayBalanceInfo(0, AnalogInputs::Resistance);
+#ifndef LCD_LAYOUT_20x4
+void Screen::Balancer::displayVoltage4_6() {
+    displayBalanceInfo(voltage4_6, 3, AnalogInputs::Voltage);
 }
 void Screen::Balancer::displayResistance4_6() {
-    displayBalanceInfo(3, AnalogInputs::Resistance);
+    displayBalanceInfo(resistance4_6, 3, AnalogInputs::Resistance);
+}
+#if MAX_BALANCE_CELLS > 6
+void Screen::Balancer::displayVoltage7_9() {
+    displayBalanceInfo(voltage7_9, 6, AnalogInputs::Voltage);
 }
 void Screen::Balancer::displayResistance7_9() {
-    displayBalanceInfo(6, AnalogInputs::Resistance);
+    displayBalanceInfo(resistance7_9, 6, AnalogInputs::Resistance);
 }
-
+#endif
+#endif
@@ -18,6 +18,13 @@
 #ifndef SCREEN_BALANCER_H_
 #define SCREEN_BALANCER_H_
 
+#include "LcdLayout.h"
+
+#ifdef LCD_LAYOUT_20x4
+#define SCREEN_BALANCER_CELLS_PER_PAGE  MAX_BALANCE_CELLS
+#else
+#define SCREEN_BALANCER_CELLS_PER_PAGE  3
+#endif
 
 namespace Screen { namespace Balancer {
 
@@ -46,19 +46,37 @@ void Screen::Cycle::displayCycles()
     uint8_t c, time = Blink::blinkTime_/8;
     uint8_t all_scr = ProgramDCcycle::currentCycle/2 + 1;
     c = time % all_scr;
-    lcdSetCursor0_0();
-    lcdPrintUnsigned(c+1, 1);
-    lcdPrintChar(SCREEN_EMPTY_CELL_CHAR);
-    lcdPrintTime(cyclesHistoryTime[c*2], 6);
-    lcdPrintSpace1();
-    lcdPrintChar(SCREEN_FULL_CELL_CHAR);
-    lcdPrintTime(cyclesHistoryTime[c*2+1], 6);
-    lcdPrintSpaces();
+    //one cycle per 2 lines
+    for(uint8_t i = 0; i < LCD_LINES/2; i++, c++) {
+        if(c >= all_scr) c = 0;
+        lcdSetCursor(0, i*2);
+        if(i < all_scr) {
+            lcdPrintUnsigned(c+1, 1);
+            lcdPrintChar(SCREEN_EMPTY_CELL_CHAR);
+            lcdPrintTime(cyclesHistoryTime[c*2], 6);
+            lcdPrintSpace1();
+            lcdPrintChar(SCREEN_FULL_CELL_CHAR);
+            lcdPrintTime(cyclesHistoryTime[c*2+1], 6);
+        }
+        lcdPrintSpaces();
+
+        lcdSetCursor(0, i*2+1);
+        if(i < all_scr) {
+            lcdPrintCharge(cyclesHistoryCapacity[c*2],8);
+            lcdPrintCharge(cyclesHistoryCapacity[c*2+1],8);
+        }
+        lcdPrintSpaces();
+    }
+}
 
+void Screen::Cycle::displayRelaxation()
+{
+    lcdSetCursor0_0();
+    lcdPrint_P(PSTR("rest: "));
+    lcdPrintTime(DelayStrategy::getRestTime(), 10);
     lcdSetCursor0_1();
-    lcdPrintCharge(cyclesHistoryCapacity[c*2],8);
-    lcdPrintCharge(cyclesHistoryCapacity[c*2+1],8);
-    lcdPrintSpaces();
+    lcdPrint_P(PSTR("tau:  "));
+    lcdPrintTime(DelayStrategy::getRelaxationTau(), 10);
 }
 
 void Screen::Cycle::resetCycleHistory()
@@ -22,6 +22,7 @@
 namespace Screen { namespace Cycle {
 
     void displayCycles();
+    void displayRelaxation();
     void resetCycleHistory();
     void storeCycleHistoryInfo();
 
@@ -0,0 +1,101 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "memory.h"
+#include "Screen.h"
+#include "LcdPrint.h"
+#include "LcdGlyph.h"
+#include "AnalogInputs.h"
+#include "ScreenMethods.h"
+#include "ScreenGraph.h"
+
+#ifdef ENABLE_LCD_GLYPHS
+
+//sparkline width in chars
+#define SCREEN_GRAPH_CHARS      5
+#define SCREEN_GRAPH_SAMPLES    (SCREEN_GRAPH_CHARS*LCD_GLYPH_WIDTH)
+
+namespace Screen { namespace Graph {
+
+    //the newest sample is the last one
+    AnalogInputs::ValueType samples_[SCREEN_GRAPH_SAMPLES];
+    uint8_t count_;
+    uint16_t time_;
+
+} // namespace Graph
+} // namespace Screen
+
+void Screen::Graph::resetHistory()
+{
+    count_ = 0;
+    time_ = Time::getSecondsU16();
+}
+
+void Screen::Graph::storeHistory()
+{
+    uint16_t time = Time::getSecondsU16();
+    if(count_ && Time::diffU16(time_, time) < SCREEN_GRAPH_PERIOD)
+        return;
+    time_ = time;
+    for(uint8_t i = 1; i < SCREEN_GRAPH_SAMPLES; i++) {
+        samples_[i-1] = samples_[i];
+    }
+    samples_[SCREEN_GRAPH_SAMPLES-1] = AnalogInputs::getRealValue(AnalogInputs::Iout);
+    if(count_ < SCREEN_GRAPH_SAMPLES)
+        count_++;
+}
+
+void Screen::Graph::displayCurrent()
+{
+    AnalogInputs::ValueType max = 1;
+    for(uint8_t i = SCREEN_GRAPH_SAMPLES - count_; i < SCREEN_GRAPH_SAMPLES; i++) {
+        if(samples_[i] > max) max = samples_[i];
+    }
+
+    char graph[SCREEN_GRAPH_CHARS];
+    uint8_t levels[LCD_GLYPH_WIDTH];
+    LcdGlyph::beginFrame();
+    for(uint8_t c = 0; c < SCREEN_GRAPH_CHARS; c++) {
+        for(uint8_t j = 0; j < LCD_GLYPH_WIDTH; j++) {
+            uint8_t i = c * LCD_GLYPH_WIDTH + j;
+            uint8_t level = 0;
+            if(i >= SCREEN_GRAPH_SAMPLES - count_) {
+                //the lowest row shows the time axis
+                level = 1 + uint32_t(samples_[i]) * (LCD_GLYPH_HEIGHT - 1) / max;
+            }
+            levels[j] = level;
+        }
+        graph[c] = LcdGlyph::getColumns(levels, '_');
+    }
+
+    lcdSetCursor0_0();
+    lcdPrintChar('I');
+    for(uint8_t c = 0; c < SCREEN_GRAPH_CHARS; c++) {
+        lcdPrintChar(graph[c]);
+    }
+    lcdPrintSpace1();
+    AnalogInputs::printRealValue(AnalogInputs::Iout, 7);
+    lcdPrintSpaces();
+
+    lcdSetCursor0_1();
+    Screen::Methods::printCharAndTime();
+    lcdPrint_P(PSTR("^"));
+    lcdPrintCurrent(max, 6);
+    lcdPrintSpaces();
+}
+
+#endif //ENABLE_LCD_GLYPHS
@@ -22,6 +22,7 @@
 #include "Screen.h"
 #include "ScreenStartInfo.h"
 #include "ScreenCycle.h"
+#include "ScreenGraph.h"
 #include "ScreenBalancer.h"
 #include "ScreenMethods.h"
 #include "ScreenEditable.h"
@@ -30,8 +31,8 @@
 namespace Screen { namespace Pages {
 
 /*condition bits:
- * 0..8:    PAGE_PROGRAM(..)
- * 9..16:   PAGE_BATTERY(CLASS)
+ * 0..10:   PAGE_PROGRAM(..)
+ * 11..28:  PAGE_BATTERY(CLASS), see ProgramData::Chemistry::batteryClass
  * 29:      PAGE_START_INFO
  * 30:      PAGE_BALANCE_PORT
 */
@@ -39,37 +40,47 @@ namespace Screen { namespace Pages {
         VoidMethod displayMethod;
         uint32_t conditionEnable;
         uint32_t conditionDisable;
+        uint16_t refresh;
     };
 
     const PageInfo pageInfo[] PROGMEM = {
-            {Screen::StartInfo::displayStartInfo,   PAGE_START_INFO,                      PAGE_NONE},
-            {Screen::Editable::displayLEDScreen,     PAGE_BATTERY(ProgramData::ClassLED), PAGE_START_INFO},
-            {Screen::Methods::displayFirstScreen,   PAGE_ALWAYS, PAGE_START_INFO + PAGE_PROGRAM(Program::Balance)},
-            {Screen::Cycle::displayCycles,          PAGE_PROGRAM(Program::CapacityCheck)+PAGE_PROGRAM(Program::DischargeChargeCycle), PAGE_START_INFO},
+            {Screen::StartInfo::displayStartInfo,   PAGE_START_INFO,                      PAGE_NONE, PAGE_REFRESH_BLINK},
+            {Screen::Editable::displayLEDScreen,     PAGE_BATTERY(ProgramData::ClassLED), PAGE_START_INFO, PAGE_REFRESH_MEASUREMENT + PAGE_REFRESH_MS(1000)},
+            {Screen::Methods::displayR,             PAGE_PROGRAM(Program::MeasureResistance), PAGE_START_INFO, PAGE_REFRESH_MEASUREMENT},
+            {Screen::Methods::displayFirstScreen,   PAGE_ALWAYS, PAGE_START_INFO + PAGE_PROGRAM(Program::Balance), PAGE_REFRESH_MEASUREMENT + PAGE_REFRESH_MS(1000)},
+            {Screen::Cycle::displayCycles,          PAGE_PROGRAM(Program::CapacityCheck)+PAGE_PROGRAM(Program::DischargeChargeCycle), PAGE_START_INFO, PAGE_REFRESH_BLINK},
+            {Screen::Cycle::displayRelaxation,      PAGE_PROGRAM(Program::CapacityCheck)+PAGE_PROGRAM(Program::DischargeChargeCycle), PAGE_START_INFO, PAGE_REFRESH_MS(1000)},
 
-            {Screen::Methods::displayDeltaFirst,    PAGE_BATTERY(ProgramData::ClassNiXX), PAGE_START_INFO + PAGE_PROGRAM(Program::Discharge)},
-            {Screen::Methods::displayDeltaVout,     PAGE_BATTERY(ProgramData::ClassNiXX), PAGE_START_INFO + PAGE_PROGRAM(Program::Discharge)},
-            {Screen::Methods::displayDeltaTextern,  PAGE_BATTERY(ProgramData::ClassNiXX), PAGE_START_INFO},
-            {Screen::Methods::displayEnergy,        PAGE_ALWAYS, PAGE_START_INFO + PAGE_PROGRAM(Program::Balance)},
+            {Screen::Methods::displayDeltaFirst,    PAGE_BATTERY(ProgramData::ClassNiXX), PAGE_START_INFO + PAGE_PROGRAM(Program::Discharge), PAGE_REFRESH_MEASUREMENT + PAGE_REFRESH_MS(1000)},
+            {Screen::Methods::displayDeltaVout,     PAGE_BATTERY(ProgramData::ClassNiXX), PAGE_START_INFO + PAGE_PROGRAM(Program::Discharge), PAGE_REFRESH_MEASUREMENT},
+            {Screen::Methods::displayDeltaTextern,  PAGE_BATTERY(ProgramData::ClassNiXX), PAGE_START_INFO, PAGE_REFRESH_MEASUREMENT},
+            {Screen::Methods::displayEnergy,        PAGE_ALWAYS, PAGE_START_INFO + PAGE_PROGRAM(Program::Balance), PAGE_REFRESH_MEASUREMENT},
+#ifdef ENABLE_LCD_GLYPHS
+            {Screen::Graph::displayCurrent,         PAGE_ALWAYS, PAGE_START_INFO + PAGE_PROGRAM(Program::Balance), PAGE_REFRESH_MEASUREMENT + PAGE_REFRESH_MS(1000)},
+#endif
 
-            {Screen::Balancer::displayVoltage1_3,   PAGE_START_INFO + PAGE_BALANCE_PORT , PAGE_NONE},
-            {Screen::Balancer::displayVoltage4_6,   PAGE_START_INFO + PAGE_BALANCE_PORT , PAGE_NONE},
+            {Screen::Balancer::displayVoltage1_3,   PAGE_START_INFO + PAGE_BALANCE_PORT , PAGE_NONE, PAGE_REFRESH_MEASUREMENT + PAGE_REFRESH_BLINK},
+#ifndef LCD_LAYOUT_20x4
+            {Screen::Balancer::displayVoltage4_6,   PAGE_START_INFO + PAGE_BALANCE_PORT , PAGE_NONE, PAGE_REFRESH_MEASUREMENT + PAGE_REFRESH_BLINK},
 BALANCER_PORTS_GT_6(
-            {Screen::Balancer::displayVoltage7_9,   PAGE_START_INFO + PAGE_BALANCE_PORT , PAGE_NONE},)
+            {Screen::Balancer::displayVoltage7_9,   PAGE_START_INFO + PAGE_BALANCE_PORT , PAGE_NONE, PAGE_REFRESH_MEASUREMENT + PAGE_REFRESH_BLINK},)
+#endif
 
-            {Screen::Balancer::displayResistance1_3,PAGE_BALANCE_PORT, PAGE_START_INFO + PAGE_PROGRAM(Program::Balance)},
-            {Screen::Balancer::displayResistance4_6,PAGE_BALANCE_PORT, PAGE_START_INFO + PAGE_PROGRAM(Program::Balance)},
+            {Screen::Balancer::displayResistance1_3,PAGE_BALANCE_PORT, PAGE_START_INFO + PAGE_PROGRAM(Program::Balance), PAGE_REFRESH_MEASUREMENT},
+#ifndef LCD_LAYOUT_20x4
+            {Screen::Balancer::displayResistance4_6,PAGE_BALANCE_PORT, PAGE_START_INFO + PAGE_PROGRAM(Program::Balance), PAGE_REFRESH_MEASUREMENT},
 BALANCER_PORTS_GT_6(
-            {Screen::Balancer::displayResistance7_9,PAGE_BALANCE_PORT, PAGE_START_INFO + PAGE_PROGRAM(Program::Balance)},)
+            {Screen::Balancer::displayResistance7_9,PAGE_BALANCE_PORT, PAGE_START_INFO + PAGE_PROGRAM(Program::Balance), PAGE_REFRESH_MEASUREMENT},)
+#endif
 
-            {Screen::Methods::displayR,             PAGE_ALWAYS, PAGE_START_INFO + PAGE_PROGRAM(Program::Balance)},
+            {Screen::Methods::displayR,             PAGE_ALWAYS, PAGE_START_INFO + PAGE_PROGRAM(Program::Balance) + PAGE_PROGRAM(Program::MeasureResistance), PAGE_REFRESH_MEASUREMENT},
 
-            {Screen::Methods::displayTime,          PAGE_ALWAYS, PAGE_START_INFO},
-            {Screen::Methods::displayTemperature,   PAGE_ALWAYS, PAGE_NONE},
-            {Screen::Methods::displayCIVlimits,     PAGE_ALWAYS, PAGE_PROGRAM(Program::Balance)},
-            {Screen::Methods::displayVinput,        PAGE_ALWAYS, PAGE_NONE},
+            {Screen::Methods::displayTime,          PAGE_ALWAYS, PAGE_START_INFO, PAGE_REFRESH_MS(1000)},
+            {Screen::Methods::displayTemperature,   PAGE_ALWAYS, PAGE_NONE, PAGE_REFRESH_MEASUREMENT},
+            {Screen::Methods::displayCIVlimits,     PAGE_ALWAYS, PAGE_PROGRAM(Program::Balance), PAGE_REFRESH_MEASUREMENT},
+            {Screen::Methods::displayVinput,        PAGE_ALWAYS, PAGE_NONE, PAGE_REFRESH_MEASUREMENT},
 
-            {NULL, PAGE_ALWAYS, PAGE_NONE}
+            {NULL, PAGE_ALWAYS, PAGE_NONE, 0}
     };
 
 }};
@@ -33,7 +33,7 @@
 namespace Screen {
 namespace StartInfo {
 
-    const char programString[] PROGMEM = "ChCBBlDiFCStSBCYCC";
+    const char programString[] PROGMEM = "ChCBBlDiFCStSBCYCCIRSQ";
 
     void printProgram2chars(Program::ProgramType prog)
     {
@@ -46,7 +46,7 @@ namespace StartInfo {
     void printVoltageString(int8_t dig)
     {
         uint16_t voltage = ProgramData::getDefaultVoltage();
-        if(ProgramData::battery.type == ProgramData::UnknownBatteryType || ProgramData::battery.type == ProgramData::LED) {
+        if(!ProgramData::hasCells()) {
             voltage = ProgramData::getVoltage(ProgramData::VCharged);
             lcdPrintVoltage(voltage, dig);
         } else {
@@ -89,7 +89,7 @@ void Screen::StartInfo::displayStartInfo()
     else lcdPrintSpaces(5);
 
     lcdPrintChar(' ');
-    if(ProgramData::isLiXX()) {
+    if(ProgramData::hasBalancePort()) {
         //display balance port
         if(bindex & 2) AnalogInputs::printRealValue(AnalogInputs::Vbalancer, 5);
         else lcdPrintSpaces(5);
@@ -4,6 +4,8 @@ set(CORE_SOURCE
     ScreenBalancer.h    ScreenCycle.cpp  Screen.h       ScreenMethods.h    screens.cmake  ScreenStartInfo.h
     ScreenEditable.cpp
     ScreenEditable.h
+    ScreenGraph.cpp
+    ScreenGraph.h
 )
 
 CHEALI_ADD("CORE_SOURCE_FILES" "${CORE_SOURCE}")
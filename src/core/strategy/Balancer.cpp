@@ -24,6 +24,7 @@
 #include "Hardware.h"
 #include "memory.h"
 #include "Utils.h"
+#include "atomic.h"
 
 //#define ENABLE_DEBUG
 #include "debug.h"
@@ -37,9 +38,64 @@ namespace Balancer {
     uint16_t startBalanceTimeSecondsU16_;
     uint16_t balancingEnded;
 
+    //software PWM, duty in 1/BALANCER_PWM_STEPS
+    volatile uint8_t i_duty_[MAX_BALANCE_CELLS];
+    uint8_t i_pwmCounter_;
+    uint16_t i_output_;
+
+    //balancing plan: all cells bleed their estimated excess charge within planTime_
+    uint16_t planTime_;
+    uint16_t planBleedTime_[MAX_BALANCE_CELLS];
+    AnalogInputs::ValueType planExcess_[MAX_BALANCE_CELLS];
+
+#ifdef ENABLE_BALANCER_DISCHARGE
+    //all balancer loads help the discharger
+    bool auxDischarge_;
+    bool auxHot_;
+    //lead resistance refit: Voff_ is measured with the loads off, then Von_ with auxDuty_
+    bool auxSaveVoff_;
+    uint8_t auxDuty_[MAX_BALANCE_CELLS];
+    //leads that carried current during the last fit
+    uint16_t auxLeads_;
+#endif
+
     uint32_t IVtime_;
     AnalogInputs::ValueType V_[MAX_BALANCE_CELLS];
 
+    //balance lead resistance model:
+    //lead i connects the balance port tap i (between cell i-1 and cell i) to the charger,
+    //the bleed current flowing through a lead shifts both neighbouring cell readings
+    uint16_t Rlead_[MAX_BALANCE_CELLS + 1];
+    uint16_t leadKnown_;
+
+    int8_t getLeadCurrent(const volatile uint8_t * duty, uint8_t lead) {
+        //average bleed current in lead (in BALANCER_I/BALANCER_PWM_STEPS units)
+        int8_t retu = 0;
+        if(lead > 0) retu += duty[lead - 1];
+        if(lead < MAX_BALANCE_CELLS) retu -= duty[lead];
+        return retu;
+    }
+
+    int8_t getLeadCurrent(uint8_t lead) {
+        return getLeadCurrent(i_duty_, lead);
+    }
+
+    void setDuty(const uint8_t * duty) {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            for(uint8_t c = 0; c < MAX_BALANCE_CELLS; c++) {
+                i_duty_[c] = duty[c];
+            }
+        }
+    }
+
+    void addLeadR(uint8_t lead, int32_t dR) {
+        dR += Rlead_[lead];
+        if(dR < 0) dR = 0;
+        if(dR > maxLeadR) dR = maxLeadR;
+        Rlead_[lead] = dR;
+        leadKnown_ |= 1 << lead;
+    }
+
     bool isWorking()  {
         if(balance != 0)
             return true;
@@ -80,6 +136,15 @@ void Balancer::powerOn()
         AnalogInputs::ValueType vi = getV(i);
         Voff_[i] = Von_[i] = vi;
     }
+    for(uint8_t i = 0; i <= MAX_BALANCE_CELLS; i++) {
+        Rlead_[i] = 0;
+    }
+    leadKnown_ = 0;
+    planTime_ = 0;
+#ifdef ENABLE_BALANCER_DISCHARGE
+    auxDischarge_ = false;
+    auxHot_ = false;
+#endif
     balance = 0;
     done = false;
     setBalance(0);
@@ -109,15 +174,86 @@ AnalogInputs::ValueType Balancer::getV(uint8_t cell)
     return AnalogInputs::getRealValue(AnalogInputs::Name(AnalogInputs::Vb1+cell));
 }
 
+bool Balancer::isLeadModelValid()
+{
+    for(uint8_t i = 0; i <= MAX_BALANCE_CELLS; i++) {
+        if(getLeadCurrent(i) != 0 && !(leadKnown_ & (1 << i)))
+            return false;
+    }
+    return true;
+}
+
+int16_t Balancer::getLeadDrop(uint8_t cell)
+{
+    //voltage drop on the balance leads of "cell" caused by the bleed current
+    int32_t v;
+    v  = int32_t(Rlead_[cell + 1]) * getLeadCurrent(cell + 1);
+    v -= int32_t(Rlead_[cell]) * getLeadCurrent(cell);
+    v *= BALANCER_I;
+    v /= ANALOG_OHM(1.0) * BALANCER_PWM_STEPS;
+    return v;
+}
+
+void Balancer::updateLeadModel()
+{
+    //Kaczmarz iteration on: Voff - Von = getLeadDrop(cell)
+    //the step is halved (low pass filter) when all leads are already known
+    for(uint8_t c = 0; c < MAX_BALANCE_CELLS; c++) {
+        if(!(AnalogInputs::connectedBalancePortCells & (1<<c)))
+            continue;
+        int8_t lLow = getLeadCurrent(c), lHigh = getLeadCurrent(c + 1);
+        int16_t n = lLow * lLow + lHigh * lHigh;
+        if(n == 0)
+            continue;
+        uint16_t leads = 0;
+        if(lLow)  leads |= 1 << c;
+        if(lHigh) leads |= 1 << (c + 1);
+        if((leadKnown_ & leads) == leads)
+            n *= 2;
+        int32_t e = Voff_[c];
+        e -= Von_[c];
+        e -= getLeadDrop(c);
+        e *= ANALOG_OHM(1.0);
+        e /= BALANCER_I;
+        e *= BALANCER_PWM_STEPS;
+        e /= n;
+        if(lHigh) addLeadR(c + 1, lHigh * e);
+        if(lLow)  addLeadR(c, -lLow * e);
+    }
+}
+
 AnalogInputs::ValueType Balancer::getPresumedV(uint8_t cell)
 {
     if(balance == 0)
         return getV(cell);
 
+#ifdef ENABLE_BALANCER_DISCHARGE
+    //the duties change all the time, only the lead model can be used
+    if(auxDischarge_ && isLeadModelValid()) {
+        //never correct more than the drop measured when the leads were fitted
+        int16_t drop = getLeadDrop(cell);
+        int16_t measured = Voff_[cell] - Von_[cell];
+        if(measured < 0) {
+            if(drop > 0) drop = 0;
+            if(drop < measured) drop = measured;
+        } else {
+            if(drop < 0) drop = 0;
+            if(drop > measured) drop = measured;
+        }
+        return getV(cell) + drop;
+    }
+#endif
     if(savedVon)
         return (getV(cell) + Voff_[cell]) - Von_[cell] ;
-    else
-        return Voff_[cell];
+    //until Von is measured use the lead resistance model from previous balancing
+    if(isLeadModelValid())
+        return getV(cell) + getLeadDrop(cell);
+    return Voff_[cell];
+}
+
+bool Balancer::isPresumedVValid()
+{
+    return balance == 0 || savedVon || isLeadModelValid();
 }
 
 void Balancer::endBalancing()
@@ -129,6 +265,9 @@ void Balancer::endBalancing()
 
 void Balancer::powerOff()
 {
+#ifdef ENABLE_BALANCER_DISCHARGE
+    auxDischarge_ = false;
+#endif
     endBalancing();
     hardware::setBalancerOutput(false);
 }
@@ -139,10 +278,61 @@ void Balancer::setBalance(uint16_t v)
     if(balance != 0 && v == 0)
         balancingEnded = AnalogInputs::getFullMeasurementCount();
 
+    uint8_t duty[MAX_BALANCE_CELLS];
+    for(uint8_t c = 0; c < MAX_BALANCE_CELLS; c++) {
+        duty[c] = 0;
+        if(!done && (v & (1<<c)))
+            duty[c] = calculateDuty(c);
+    }
+    setDuty(duty);
+
     balance = v;
     AnalogInputs::resetStable();
-    if(!done)
+}
+
+uint8_t Balancer::calculateDuty(uint8_t cell)
+{
+    if(planTime_) {
+        //finish all cells at the end of the plan
+        uint32_t duty = planBleedTime_[cell];
+        duty *= BALANCER_PWM_STEPS;
+        duty /= planTime_;
+        if(duty == 0)
+            duty = 1;
+        return duty;
+    }
+
+    //bleed proportionally to the voltage excess over minCell
+    if(minCell < 0)
+        return BALANCER_PWM_STEPS;
+    AnalogInputs::ValueType v = getPresumedV(cell), vmin = getPresumedV(minCell);
+    if(v <= vmin)
+        return 0;
+    uint16_t duty = v - vmin;
+    if(duty >= fullDutyError)
+        return BALANCER_PWM_STEPS;
+    duty *= BALANCER_PWM_STEPS;
+    duty /= fullDutyError;
+    if(duty == 0)
+        duty = 1;
+    return duty;
+}
+
+void Balancer::doInterrupt()
+{
+    if(++i_pwmCounter_ >= BALANCER_PWM_STEPS)
+        i_pwmCounter_ = 0;
+
+    uint16_t v = 0, cell = 1;
+    for(uint8_t c = 0; c < MAX_BALANCE_CELLS; c++) {
+        if(i_duty_[c] > i_pwmCounter_)
+            v |= cell;
+        cell <<= 1;
+    }
+    if(v != i_output_) {
+        i_output_ = v;
         hardware::setBalancer(v);
+    }
 }
 
 void Balancer::startBalacing()
@@ -180,8 +370,79 @@ void Balancer::startBalacing()
     if(off) {
         endBalancing();
     } else {
-        setBalance(calculateBalance());
+        uint16_t v = calculateBalance();
+        calculatePlan(v);
+        setBalance(v);
+    }
+}
+
+uint32_t Balancer::getBleedTime(AnalogInputs::ValueType v, AnalogInputs::ValueType vmin)
+{
+    //excess charge from the chemistry OCV curve
+    uint16_t soc = ProgramData::ocvToSoC(v);
+    uint16_t socMin = ProgramData::ocvToSoC(vmin);
+    if(soc <= socMin)
+        return 0;
+
+    //excess charge [mAh] -> bleed time [s]
+    uint32_t t = soc - socMin;
+    t *= ProgramData::battery.capacity;
+    t /= CHEMISTRY_SOC_MAX;
+    t *= 3600;
+    t /= BALANCER_I;
+    return t;
+}
+
+void Balancer::calculatePlan(uint16_t v)
+{
+    //convert the voltage excess of each cell into the time needed to bleed it
+    uint32_t tmax = 0;
+    AnalogInputs::ValueType vmin = getPresumedV(minCell);
+    for(uint8_t c = 0; c < MAX_BALANCE_CELLS; c++) {
+        uint32_t t = 0;
+        planExcess_[c] = 0;
+        if(v & (1<<c)) {
+            AnalogInputs::ValueType vc = getPresumedV(c);
+            planExcess_[c] = vc - vmin;
+            t = getBleedTime(vc, vmin);
+            if(t > maxPlanTime)
+                t = maxPlanTime;
+        }
+        planBleedTime_[c] = t;
+        if(tmax < t) tmax = t;
     }
+    planTime_ = 0;
+    if(tmax > maxBalanceTime && ProgramData::battery.capacity != 0) {
+        planTime_ = tmax;
+    }
+    LogDebug("planTime=", planTime_);
+}
+
+bool Balancer::isPlanError()
+{
+    //re-plan only when the estimate is clearly wrong:
+    //a cell went below minCell or its excess is growing
+    if(planTime_ == 0 || !savedVon)
+        return false;
+    AnalogInputs::ValueType error = ProgramData::battery.balancerError;
+    AnalogInputs::ValueType vmin = getPresumedV(minCell);
+    for(uint8_t c = 0; c < MAX_BALANCE_CELLS; c++) {
+        if(balance & (1<<c)) {
+            AnalogInputs::ValueType v = getPresumedV(c);
+            if(v + error < vmin)
+                return true;
+            if(v > vmin + planExcess_[c] + 2*error)
+                return true;
+        }
+    }
+    return false;
+}
+
+uint16_t Balancer::getRoundTime()
+{
+    if(planTime_)
+        return planTime_;
+    return maxBalanceTime;
 }
 
 uint16_t Balancer::calculateBalance()
@@ -215,12 +476,14 @@ bool Balancer::isStable(const uint16_t stableCount)
 }
 
 void Balancer::trySaveVon() {
-    if(savedVon)
+    //wait until the first measurement taken entirely with the balancer on
+    if(savedVon || !isStable())
         return;
     savedVon = true;
     for(uint8_t c = 0; c < MAX_BALANCE_CELLS; c++) {
         Von_[c] = getV(c);
     }
+    updateLeadModel();
 }
 
 uint16_t Balancer::getBalanceTime()
@@ -232,11 +495,16 @@ uint16_t Balancer::getBalanceTime()
 Strategy::statusType Balancer::doStrategy()
 {
     LogDebug("minCell=", minCell, " balance=", balance, " conCells=", connectedCells);
+#ifdef ENABLE_BALANCER_DISCHARGE
+    //cells are kept even by doAuxDischarge
+    if(auxDischarge_)
+        return Strategy::RUNNING;
+#endif
     if(balance == 0) {
             startBalacing();
     } else {
         trySaveVon();
-        if(getBalanceTime() > maxBalanceTime) {
+        if(getBalanceTime() > getRoundTime() || isPlanError()) {
             setBalance(0);
         }
     }
@@ -260,9 +528,11 @@ bool Balancer::isMaxVout(AnalogInputs::ValueType maxV)
 
 bool Balancer::isMinVout(AnalogInputs::ValueType minV)
 {
+    //the bleed current only lowers the readings: without the lead
+    //correction a bad fit cannot over-discharge a cell
     for(uint8_t c = 0; c < MAX_BALANCE_CELLS; c++) {
         if(AnalogInputs::connectedBalancePortCells & (1<<c)) {
-            if(getPresumedV(c) <= minV)
+            if(getV(c) <= minV)
                 return true;
         }
     }
@@ -277,3 +547,87 @@ AnalogInputs::ValueType Balancer::calculatePerCell(AnalogInputs::ValueType v)
     return v/cells;
 }
 
+
+#ifdef ENABLE_BALANCER_DISCHARGE
+
+bool Balancer::doAuxDischarge(bool enable)
+{
+#ifdef ENABLE_T_INTERNAL
+    //stop before the discharger reaches dischargeTempOff
+    testTintern(auxHot_, settings.dischargeTempOff - 2*Settings::TempDifference,
+            settings.dischargeTempOff - Settings::TempDifference);
+    enable = enable && !auxHot_;
+#endif
+    enable = enable && !done && AnalogInputs::isBalancePortConnected();
+
+    if(!enable) {
+        if(auxDischarge_) {
+            auxDischarge_ = false;
+            setBalance(0);
+        }
+        return false;
+    }
+
+    if(auxDischarge_ && !savedVon) {
+        //keep the duties until the leads are fitted
+        if(auxSaveVoff_) {
+            if(isStable()) {
+                for(uint8_t c = 0; c < MAX_BALANCE_CELLS; c++) {
+                    Von_[c] = Voff_[c] = getV(c);
+                }
+                auxSaveVoff_ = false;
+                setDuty(auxDuty_);
+                AnalogInputs::resetStable();
+            }
+        } else {
+            trySaveVon();
+        }
+        return true;
+    }
+
+    //bleed all cells, the lower cells less, to keep them even
+    AnalogInputs::ValueType vmax = 0, v[MAX_BALANCE_CELLS];
+    uint16_t cells = AnalogInputs::connectedBalancePortCells;
+    for(uint8_t c = 0; c < MAX_BALANCE_CELLS; c++) {
+        v[c] = getPresumedV(c);
+        if((cells & (1<<c)) && vmax < v[c])
+            vmax = v[c];
+    }
+    uint8_t duty[MAX_BALANCE_CELLS];
+    for(uint8_t c = 0; c < MAX_BALANCE_CELLS; c++) {
+        duty[c] = 0;
+        if(cells & (1<<c)) {
+            uint16_t d = vmax - v[c];
+            if(d >= fullDutyError) {
+                d = 0;
+            } else {
+                d = BALANCER_PWM_STEPS - d * BALANCER_PWM_STEPS / fullDutyError;
+            }
+            duty[c] = d;
+        }
+    }
+
+    uint16_t leads = 0;
+    for(uint8_t l = 0; l <= MAX_BALANCE_CELLS; l++) {
+        if(getLeadCurrent(duty, l))
+            leads |= 1 << l;
+    }
+    if(!auxDischarge_ || leads != auxLeads_) {
+        //new leads carry current (or the old ones stopped): refit,
+        //first measure the cells with the loads off
+        for(uint8_t c = 0; c < MAX_BALANCE_CELLS; c++) {
+            auxDuty_[c] = duty[c];
+            duty[c] = 0;
+        }
+        auxLeads_ = leads;
+        auxSaveVoff_ = true;
+        savedVon = false;
+        auxDischarge_ = true;
+        balance = cells;
+        AnalogInputs::resetStable();
+    }
+    setDuty(duty);
+    return true;
+}
+
+#endif //ENABLE_BALANCER_DISCHARGE
@@ -28,6 +28,11 @@
 #define BALANCER_I ANALOG_AMP(0.160) //default 160mA
 #endif
 
+//software PWM period in timer interrupts (Time::callback)
+#ifndef BALANCER_PWM_STEPS
+#define BALANCER_PWM_STEPS 16
+#endif
+
 
 #include "Strategy.h"
 
@@ -35,6 +40,10 @@ namespace Balancer {
 
     const static uint16_t maxBalanceTime = 15; //15s
     const static uint16_t balancerStartStableCount = 6; //6*0.7s
+    const static uint16_t maxLeadR = ANALOG_OHM(0.500);
+    //cell voltage excess (over minCell) at which the balancer is fully on
+    const static AnalogInputs::ValueType fullDutyError = ANALOG_VOLT(0.030);
+    const static uint16_t maxPlanTime = 3600; //1h
 
     extern const Strategy::VTable vtable;
 
@@ -43,6 +52,11 @@ namespace Balancer {
     extern int8_t minCell;
     extern bool done;
     extern uint16_t balancingEnded;
+    extern volatile uint8_t i_duty_[MAX_BALANCE_CELLS];
+    extern uint16_t planTime_;
+#ifdef ENABLE_BALANCER_DISCHARGE
+    extern bool auxDischarge_;
+#endif
 
     void powerOn();
     void powerOff();
@@ -50,13 +64,24 @@ namespace Balancer {
     void startBalacing();
     void trySaveVon();
     uint16_t getBalanceTime();
+    uint16_t getRoundTime();
+
+    uint32_t getBleedTime(AnalogInputs::ValueType v, AnalogInputs::ValueType vmin);
+    void calculatePlan(uint16_t balance);
+    bool isPlanError();
 
     uint16_t calculateBalance();
+    uint8_t calculateDuty(uint8_t cell);
     void setBalance(uint16_t v);
+    void doInterrupt();
     uint8_t getCellMinV();
 
     AnalogInputs::ValueType getV(uint8_t cell);
     AnalogInputs::ValueType getPresumedV(uint8_t cell);
+    bool isPresumedVValid();
+    bool isLeadModelValid();
+    int16_t getLeadDrop(uint8_t cell);
+    void updateLeadModel();
     inline AnalogInputs::ValueType getRealV(uint8_t cell) { return getPresumedV(cell); }
     inline void resetMinCell() { minCell = -1; }
     bool isWorking();
@@ -68,6 +93,10 @@ namespace Balancer {
     void endBalancing();
 
     AnalogInputs::ValueType calculatePerCell(AnalogInputs::ValueType v);
+
+#ifdef ENABLE_BALANCER_DISCHARGE
+    bool doAuxDischarge(bool enable);
+#endif
 };
 
 #endif /* BALANCER_H_ */
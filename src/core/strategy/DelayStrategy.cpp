@@ -22,6 +22,14 @@
 #include "memory.h"
 #include "Strategy.h"
 #include "Buzzer.h"
+#include "AnalogInputs.h"
+#include "ProgramData.h"
+#include "Utils.h"
+
+//#define ENABLE_DEBUG
+#include "debug.h"
+
+#define DELAY_STRATEGY_RELAXATION_SAMPLE_TIME   30
 
 namespace DelayStrategy {
      const Strategy::VTable vtable PROGMEM = {
@@ -34,11 +42,85 @@ namespace DelayStrategy {
     uint16_t start_time_U16_;
     uint16_t delay_;
 
+    /* OCV relaxation after a charge/discharge:
+     *  V(t) = Vinf - A*exp(-t/tau)
+     * for three window averages taken every h seconds:
+     *  d12/d01 = exp(-h/tau), the remaining change: d12^2/(d01 - d12)
+     * the averages are in 1/VSCALE mV, below the 1mV resolution of a single sample
+     */
+    const uint8_t VSCALE = 16;
+    const AnalogInputs::ValueType maxResidualPerCell = ANALOG_VOLT(0.002);
+    //a change of the window average within noise (0.5mV) is no change
+    const uint8_t noise = VSCALE / 2;
+    //consecutive valid fits within the limit needed to end the rest
+    const uint8_t relaxedCount = 3;
+
+    bool relaxation_;
+    uint16_t sample_time_U16_;
+    uint8_t samples_;
+    uint8_t relaxed_;
+    uint32_t sum_;
+    uint16_t count_;
+    uint32_t v_[3];
+    uint16_t tau_;
+    uint16_t restTime_;
+
+    bool isRelaxed() {
+        int32_t d01 = int32_t(v_[1] - v_[0]);
+        int32_t d12 = int32_t(v_[2] - v_[1]);
+        if(d01 < 0) {
+            d01 = -d01;
+            d12 = -d12;
+        }
+        if(d01 <= noise && d12 <= noise && -d12 <= noise) {
+            //flat: nothing left to relax
+            return true;
+        }
+        if(d12 <= 0 || d12 >= d01) {
+            //no estimate: not an exponential decay (yet)
+            return false;
+        }
+        uint32_t residual = uint32_t(d12) * d12 / (d01 - d12);
+        uint16_t ln = ln256(d01, d12);
+        uint32_t tau = UINT16_MAX;
+        if(ln) tau = uint32_t(DELAY_STRATEGY_RELAXATION_SAMPLE_TIME) * 256 / ln;
+        tau_ = min(tau, UINT16_MAX);
+        LogDebug("d01=", int16_t(d01), " d12=", int16_t(d12), " residual=", residual, " tau=", tau_);
+        return residual <= uint32_t(maxResidualPerCell) * VSCALE * ProgramData::battery.cells;
+    }
+
+    bool doRelaxation() {
+        sum_ += AnalogInputs::getVbattery();
+        count_++;
+        if(Time::diffU16(sample_time_U16_, Time::getSecondsU16()) < DELAY_STRATEGY_RELAXATION_SAMPLE_TIME)
+            return false;
+        sample_time_U16_ += DELAY_STRATEGY_RELAXATION_SAMPLE_TIME;
+        v_[0] = v_[1];
+        v_[1] = v_[2];
+        v_[2] = sum_ * VSCALE / count_;
+        sum_ = 0;
+        count_ = 0;
+        if(samples_ < 2) {
+            samples_++;
+            return false;
+        }
+        if(isRelaxed()) relaxed_++;
+        else relaxed_ = 0;
+        return relaxed_ >= relaxedCount;
+    }
+
 }// namespace DelayStrategy
 
 void DelayStrategy::powerOn()
 {
     start_time_U16_ = Time::getSecondsU16();
+    sample_time_U16_ = start_time_U16_;
+    samples_ = 0;
+    relaxed_ = 0;
+    sum_ = 0;
+    count_ = 0;
+    tau_ = 0;
+    restTime_ = 0;
 }
 
 void DelayStrategy::powerOff()
@@ -48,7 +130,8 @@ void DelayStrategy::powerOff()
 
 Strategy::statusType DelayStrategy::doStrategy()
 {
-    if(Time::diffU16(start_time_U16_, Time::getSecondsU16()) <= delay_) {
+    restTime_ = Time::diffU16(start_time_U16_, Time::getSecondsU16());
+    if(restTime_ <= delay_ && !(relaxation_ && doRelaxation())) {
         state_ = true;
         return Strategy::RUNNING;
     } else {
@@ -65,5 +148,22 @@ bool DelayStrategy::isDelay()
 void DelayStrategy::setDelay(uint16_t minutes)
 {
    delay_ = minutes*60;
+   relaxation_ = false;
+}
+
+void DelayStrategy::setRelaxationDelay(uint16_t maxMinutes)
+{
+   setDelay(maxMinutes);
+   relaxation_ = true;
+}
+
+uint16_t DelayStrategy::getRelaxationTau()
+{
+   return tau_;
+}
+
+uint16_t DelayStrategy::getRestTime()
+{
+   return restTime_;
 }
 
@@ -30,6 +30,12 @@ namespace DelayStrategy {
 
     bool isDelay();
     void setDelay(uint16_t minutes);
+    //end the delay when the battery voltage has relaxed (at most maxMinutes)
+    void setRelaxationDelay(uint16_t maxMinutes);
+
+    //fitted OCV relaxation time constant of the last delay (0 - unknown)
+    uint16_t getRelaxationTau();
+    uint16_t getRestTime();
 
 };
 
@@ -18,6 +18,7 @@
 #include "Discharger.h"
 #include "Utils.h"
 #include "Settings.h"
+#include "Thermal.h"
 
 
 namespace Discharger {
@@ -48,6 +49,9 @@ namespace Discharger {
 
         if(i > settings.maxId)
             i = settings.maxId;
+#ifdef ENABLE_T_INTERNAL
+        i = Thermal::derate(i);
+#endif
         return i;
     }
 }
@@ -0,0 +1,164 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2016  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "InputPowerLimit.h"
+#include "Settings.h"
+#include "SMPS.h"
+#include "Time.h"
+
+//#define ENABLE_DEBUG
+#include "debug.h"
+
+namespace InputPowerLimit {
+    //forgetting factor = 1 - 1/(2^forgetShift)
+    const static uint8_t forgetShift = 4;
+    //the fit needs some variation of the input current: (100mA)^2
+    const static int32_t minVarianceI = 100L*100;
+    const static uint16_t maxR = ANALOG_OHM(2.000);
+    const static uint16_t maxTrim = 256;
+
+    uint16_t lastMeasurement_;
+    //means scaled by 2^forgetShift
+    int32_t meanI_;
+    int32_t meanV_;
+    int32_t varianceI_;
+    int32_t covarianceIV_;
+
+    uint16_t R_;
+    AnalogInputs::ValueType Vs_;
+    uint16_t trim_;
+    AnalogInputs::ValueType maxPc_;
+    //last time maxPc_ was > 0 (or the SMPS was off)
+    uint16_t notZeroTime_;
+
+    AnalogInputs::ValueType getInputCurrent(AnalogInputs::ValueType Vin) {
+        if(!SMPS::isWorking() || Vin == 0)
+            return 0;
+        uint32_t P = AnalogInputs::getRealValue(AnalogInputs::Pout);
+        P *= 100;
+        P /= INPUT_POWER_LIMIT_EFFICIENCY;
+        if(P > UINT16_MAX) P = UINT16_MAX;
+        return AnalogInputs::evalI(P, Vin);
+    }
+
+    void fit(AnalogInputs::ValueType I, AnalogInputs::ValueType V) {
+        int32_t dI = int32_t(I) - (meanI_ >> forgetShift);
+        int32_t dV = int32_t(V) - (meanV_ >> forgetShift);
+        meanI_ += dI;
+        meanV_ += dV;
+        varianceI_ += (dI*dI - varianceI_) >> forgetShift;
+        covarianceIV_ += (dI*dV - covarianceIV_) >> forgetShift;
+
+        if(varianceI_ > minVarianceI) {
+            //Rs = -cov(I,V)/var(I), [mV/mA] -> [mOhm]
+            int32_t r = -covarianceIV_;
+            if(r < 0) r = 0;
+            r /= varianceI_ / ANALOG_OHM(1.000);
+            if(r > maxR) r = maxR;
+            R_ = r;
+        }
+        //Vs = mean(V) + Rs*mean(I)
+        uint32_t v = (meanI_ >> forgetShift);
+        v *= R_;
+        v /= ANALOG_OHM(1.000);
+        v += meanV_ >> forgetShift;
+        if(v > UINT16_MAX) v = UINT16_MAX;
+        Vs_ = v;
+    }
+
+    AnalogInputs::ValueType getModelMaxPc(AnalogInputs::ValueType Vmin) {
+        if(R_ == 0)
+            return settings.maxPc;
+        if(Vs_ <= Vmin)
+            return 0;
+        //Iin = (Vs - Vmin)/Rs, Pin = Vmin*Iin
+        uint32_t I = Vs_ - Vmin;
+        I *= ANALOG_OHM(1.000);
+        I /= R_;
+        if(I > UINT16_MAX) I = UINT16_MAX;
+        //[mW]
+        uint32_t P = I * Vmin / ANALOG_VOLT(1.000);
+        P = P * INPUT_POWER_LIMIT_EFFICIENCY / 100;
+        //[mW] -> ANALOG_WATT
+        P /= 1000 / ANALOG_WATT(1.000);
+        if(P > settings.maxPc) P = settings.maxPc;
+        return P;
+    }
+}
+
+void InputPowerLimit::initialize()
+{
+    lastMeasurement_ = AnalogInputs::getFullMeasurementCount();
+    AnalogInputs::ValueType Vin = AnalogInputs::getRealValue(AnalogInputs::Vin);
+    meanI_ = 0;
+    meanV_ = int32_t(Vin) << forgetShift;
+    varianceI_ = 0;
+    covarianceIV_ = 0;
+    R_ = 0;
+    Vs_ = Vin;
+    trim_ = maxTrim;
+    maxPc_ = settings.maxPc;
+    notZeroTime_ = Time::getSecondsU16();
+}
+
+void InputPowerLimit::doMeasurement()
+{
+    uint16_t m = AnalogInputs::getFullMeasurementCount();
+    if(m == lastMeasurement_)
+        return;
+    lastMeasurement_ = m;
+
+    AnalogInputs::ValueType Vin = AnalogInputs::getRealValue(AnalogInputs::Vin);
+    fit(getInputCurrent(Vin), Vin);
+
+    //feedback on top of the model: back off fast, recover slowly
+    AnalogInputs::ValueType Vmin = settings.inputVoltageLow + INPUT_POWER_LIMIT_MARGIN;
+    if(Vin < Vmin) {
+        if(trim_) trim_ -= trim_/8 + 1;
+    } else if(trim_ < maxTrim) {
+        trim_ += 2;
+    }
+
+    uint32_t P = getModelMaxPc(Vmin);
+    P *= trim_;
+    P /= maxTrim;
+    maxPc_ = P;
+    if(P || !SMPS::isWorking())
+        notZeroTime_ = Time::getSecondsU16();
+    LogDebug("Vin=", Vin, " Vs=", Vs_, " R=", R_, " trim=", trim_, " Pmax=", maxPc_);
+}
+
+AnalogInputs::ValueType InputPowerLimit::getMaxPc()
+{
+    return maxPc_;
+}
+
+uint16_t InputPowerLimit::getSourceResistance()
+{
+    return R_;
+}
+
+AnalogInputs::ValueType InputPowerLimit::getSourceVoltage()
+{
+    return Vs_;
+}
+
+bool InputPowerLimit::isSourceTooWeak()
+{
+    return maxPc_ == 0
+            && Time::diffU16(notZeroTime_, Time::getSecondsU16()) > INPUT_POWER_LIMIT_ZERO_TIMEOUT;
+}
@@ -0,0 +1,46 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2016  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef INPUTPOWERLIMIT_H_
+#define INPUTPOWERLIMIT_H_
+
+#include "AnalogInputs.h"
+
+//keep Vin above settings.inputVoltageLow + margin
+#define INPUT_POWER_LIMIT_MARGIN        ANALOG_VOLT(0.500)
+//assumed SMPS efficiency in %, used to estimate the input current
+#define INPUT_POWER_LIMIT_EFFICIENCY    85
+//stop the program when the limit stays at 0 for this long (seconds)
+#define INPUT_POWER_LIMIT_ZERO_TIMEOUT  30
+
+//limits the charge power when the power source (e.g. a lead-acid car battery) sags:
+//Vin = Vs - Rs*Iin is fitted with an exponentially weighted least squares,
+//the charge power is limited to what keeps Vin above the margin
+namespace InputPowerLimit {
+    void initialize();
+    void doMeasurement();
+
+    //charge power limit, at most settings.maxPc
+    AnalogInputs::ValueType getMaxPc();
+    //source resistance in mOhm (0 - unknown)
+    uint16_t getSourceResistance();
+    AnalogInputs::ValueType getSourceVoltage();
+    //the source can't deliver any charge power for INPUT_POWER_LIMIT_ZERO_TIMEOUT
+    bool isSourceTooWeak();
+};
+
+#endif /* INPUTPOWERLIMIT_H_ */
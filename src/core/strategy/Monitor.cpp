@@ -30,22 +30,25 @@
 #include "LcdPrint.h"
 #include "Screen.h"
 #include "TheveninMethod.h"
-
-#if defined(ENABLE_FAN) && defined(ENABLE_T_INTERNAL)
-#define MONITOR_T_INTERNAL_FAN
-#endif
+#include "StateOfCharge.h"
+#include "Thermal.h"
+#include "InputPowerLimit.h"
 
 
 
 namespace Monitor {
     volatile uint8_t i_externalError;
-    uint32_t etaDeltaSec;
-    uint32_t etaStartTimeCalc;
 
     bool isBalancePortConnected;
 
     bool on_;
+#ifndef ENABLE_STATE_OF_CHARGE
+    uint32_t etaDeltaSec;
+    uint32_t etaStartTimeCalc;
     uint8_t procent_;
+
+    void calculateDeltaProcentTimeSec();
+#endif
     uint32_t startTime_totalTime_;
     uint32_t totalBalanceTime_;
     uint32_t totalChargDischargeTime_;
@@ -53,10 +56,67 @@ namespace Monitor {
     uint16_t Vout_plus_adcMinLimit_;
     uint16_t Vout_plus_adcMaxLimit_;
 
-    void calculateDeltaProcentTimeSec();
+#ifdef ENABLE_FAST_TRIP
+    //ADC limits, UINT16_MAX - disabled
+    uint16_t i_fastTripVout_plus_ = UINT16_MAX;
+    uint16_t i_fastTripIsmps_ = UINT16_MAX;
+    uint16_t i_fastTripIdischarge_ = UINT16_MAX;
+    uint8_t i_fastTripCount_;
+
+    void setFastTripLimits(uint16_t Vout_plus, uint16_t Ismps, uint16_t Idischarge) {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            i_fastTripVout_plus_ = Vout_plus;
+            i_fastTripIsmps_ = Ismps;
+            i_fastTripIdischarge_ = Idischarge;
+            i_fastTripCount_ = 0;
+        }
+    }
+#endif
 
 } // namespace Monitor
 
+#ifdef ENABLE_FAST_TRIP
+void Monitor::fastTrip(AnalogInputs::Name name, uint16_t adc)
+{
+    uint16_t limit;
+    uint8_t error;
+    if(name == AnalogInputs::Vout_plus_pin) {
+        limit = i_fastTripVout_plus_;
+        error = MONITOR_EXTERNAL_ERROR_BATTERY_DISCONNECTED;
+    } else if(name == AnalogInputs::Ismps) {
+        limit = i_fastTripIsmps_;
+        error = MONITOR_EXTERNAL_ERROR_OVER_CURRENT;
+    } else if(name == AnalogInputs::Idischarge) {
+        limit = i_fastTripIdischarge_;
+        error = MONITOR_EXTERNAL_ERROR_OVER_CURRENT;
+    } else {
+        return;
+    }
+
+    if(adc < limit) {
+        i_fastTripCount_ = 0;
+        return;
+    }
+    if(++i_fastTripCount_ < MONITOR_FAST_TRIP_SAMPLES) {
+        return;
+    }
+
+    hardware::setBatteryOutput(false);
+    if(i_externalError == MONITOR_EXTERNAL_ERROR_NONE) {
+        i_externalError = error;
+    }
+    //don't trip again until the next program
+    i_fastTripVout_plus_ = i_fastTripIsmps_ = i_fastTripIdischarge_ = UINT16_MAX;
+}
+#endif
+
+#ifdef ENABLE_STATE_OF_CHARGE
+uint32_t Monitor::getETATime()
+{
+    if(!on_) return 0;
+    return StateOfCharge::getETATime();
+}
+#else
 void Monitor::calculateDeltaProcentTimeSec()
 {
     uint32_t etaSec;
@@ -83,6 +143,7 @@ uint32_t Monitor::getETATime()
     //if (getChargeProcent()==99) {return (0);} //no avail more calc (or call secondary calculator)
     return (etaDeltaSec*(kx-procent_));
 }
+#endif
 
 uint32_t Monitor::getTimeSec()
 {
@@ -106,6 +167,13 @@ uint16_t Monitor::getTotalChargeDischargeTimeMin() {
 
 
 uint8_t Monitor::getChargeProcent() {
+#ifdef ENABLE_STATE_OF_CHARGE
+    uint8_t procent;
+    if(on_) procent = StateOfCharge::getProcent();
+    else procent = StateOfCharge::getOcvSoC() / (STATE_OF_CHARGE_MAX / 100);
+    if(procent > 99) procent = 99; //not 101% with isCharge
+    return procent;
+#else
     uint16_t v1,v2, v;
     v2 = ProgramData::getVoltage(ProgramData::VCharged);
     v1 = ProgramData::getVoltage(ProgramData::VvalidEmpty);
@@ -119,33 +187,28 @@ uint8_t Monitor::getChargeProcent() {
     v=  v/v2;
     if(v > 99) v=99; //not 101% with isCharge
     return v;
+#endif
 }
 
 void Monitor::doIdle()
 {
-#ifdef MONITOR_T_INTERNAL_FAN
-    bool fan;
+#ifdef ENABLE_T_INTERNAL
+    Thermal::doIdle();
+#endif
+#ifdef ENABLE_THERMAL_FAN
+    uint8_t fan;
     if(settings.fanOn == Settings::FanAlways) {
-        fan = true;
+        fan = THERMAL_FAN_MAX;
     } else if (settings.fanOn == Settings::FanDisabled
                || (settings.fanOn == Settings::FanProgramTemperature && on_ == false)) {
-        fan = false;
+        fan = 0;
     } else if (settings.fanOn == Settings::FanProgram) {
-        fan = on_;
-    } else if ((settings.fanOn == Settings::FanProgramTemperature && on_ == true)
-               || settings.fanOn == Settings::FanTemperature) {
-        AnalogInputs::ValueType t = AnalogInputs::getRealValue(AnalogInputs::Tintern);
-
-        if (t < settings.fanTempOn - Settings::TempDifference) {
-            fan = false;
-        } else if (t > settings.fanTempOn) {
-            fan = true;
-        } else {
-            // don't update fan (hysteresis)
-            return;
-        }
+        fan = on_ ? THERMAL_FAN_MAX : 0;
+    } else {
+        //FanTemperature or FanProgramTemperature with a running program
+        fan = Thermal::getFanPI();
     }
-    hardware::setFan(fan);
+    Thermal::setFan(fan);
 #endif
 }
 
@@ -169,10 +232,23 @@ void Monitor::powerOn()
         }
     }
 
+#ifdef ENABLE_FAST_TRIP
+    //hardware limits, Monitor::run checks the averaged values against the (lower) program limits
+    setFastTripLimits(Vout_plus_adcMaxLimit_,
+            AnalogInputs::reverseCalibrateValue(AnalogInputs::Ismps, MAX_CHARGE_I + ANALOG_AMP(1.000)),
+            AnalogInputs::reverseCalibrateValue(AnalogInputs::Idischarge, MAX_DISCHARGE_I + ANALOG_AMP(1.000)));
+#endif
+
     isBalancePortConnected = AnalogInputs::isBalancePortConnected();
 
     startTime_totalTime_ = Time::getSeconds();
     resetAccumulatedMeasurements();
+#ifdef ENABLE_STATE_OF_CHARGE
+    StateOfCharge::initialize();
+#endif
+#ifdef ENABLE_INPUT_POWER_LIMIT
+    InputPowerLimit::initialize();
+#endif
     i_externalError = MONITOR_EXTERNAL_ERROR_NONE;
     on_ = true;
     AnalogInputs::saveBalancePortState();
@@ -180,9 +256,13 @@ void Monitor::powerOn()
 
 void Monitor::resetAccumulatedMeasurements()
 {
+#ifdef ENABLE_STATE_OF_CHARGE
+    StateOfCharge::resetCharge();
+#else
     procent_ = getChargeProcent();
     etaStartTimeCalc = 0;
     etaDeltaSec = 0;
+#endif
 
     totalBalanceTime_ = 0;
     totalChargDischargeTime_ = 0;
@@ -193,6 +273,9 @@ void Monitor::powerOff()
 {
     startTime_totalTime_ = getTimeSec();
     on_ = false;
+#ifdef ENABLE_FAST_TRIP
+    setFastTripLimits(UINT16_MAX, UINT16_MAX, UINT16_MAX);
+#endif
 }
 
 void Monitor::doSlowInterrupt()
@@ -210,6 +293,17 @@ Strategy::statusType Monitor::run()
     if(!on_) {
         return Strategy::RUNNING;
     }
+#ifdef ENABLE_STATE_OF_CHARGE
+    StateOfCharge::doMeasurement();
+#endif
+#ifdef ENABLE_INPUT_POWER_LIMIT
+    InputPowerLimit::doMeasurement();
+    if(InputPowerLimit::isSourceTooWeak()) {
+        Program::stopReason = string_inputVoltageToLow;
+        return Strategy::ERROR;
+    }
+#endif
+
 #ifdef ENABLE_T_INTERNAL
     AnalogInputs::ValueType t = AnalogInputs::getRealValue(AnalogInputs::Tintern);
 
@@ -230,6 +324,10 @@ Strategy::statusType Monitor::run()
         Program::stopReason = string_batteryDisconnected;
         return Strategy::ERROR;
     }
+    if(externalError == MONITOR_EXTERNAL_ERROR_OVER_CURRENT) {
+        Program::stopReason = string_outputCurrentToHigh;
+        return Strategy::ERROR;
+    }
 
     if (isBalancePortConnected != AnalogInputs::isBalancePortConnected()) {
         Program::stopReason = string_balancePortDisconnected;
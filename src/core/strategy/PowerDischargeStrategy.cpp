@@ -0,0 +1,101 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2016  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "Hardware.h"
+#include "ProgramData.h"
+#include "PowerDischargeStrategy.h"
+#include "TheveninDischargeStrategy.h"
+#include "Balancer.h"
+#include "memory.h"
+
+//#define ENABLE_DEBUG
+#include "debug.h"
+
+namespace PowerDischargeStrategy {
+    const Strategy::VTable vtable PROGMEM = {
+        powerOn,
+        powerOff,
+        doStrategy
+    };
+
+    //number of measurements below endV before the discharge ends
+    const static uint8_t endVoutCount = 3;
+
+    uint8_t endCount_;
+    //closed loop correction of the current, 1/256 units
+    uint16_t gain_;
+
+    AnalogInputs::ValueType calculateI(AnalogInputs::ValueType V) {
+        uint32_t I;
+        if(ProgramData::battery.dischargeMode == ProgramData::DischargePower) {
+            //I = P/V, corrected by the measured power
+            AnalogInputs::ValueType P = AnalogInputs::getRealValue(AnalogInputs::Pout);
+            if(P && AnalogInputs::isOutStable()) {
+                uint32_t g = gain_;
+                g *= ProgramData::battery.dischargeValue;
+                g /= P;
+                if(g > 512) g = 512;
+                //low pass filter
+                gain_ = (gain_ + g) / 2;
+            }
+            I = AnalogInputs::evalI(ProgramData::battery.dischargeValue, V);
+            I *= gain_;
+            I /= 256;
+        } else {
+            //I = V/R
+            I = V;
+            I *= ANALOG_OHM(1.0);
+            I /= ProgramData::battery.dischargeValue;
+        }
+        if(I > Strategy::maxI)
+            I = Strategy::maxI;
+        return I;
+    }
+}
+
+void PowerDischargeStrategy::powerOff()
+{
+    Discharger::powerOff();
+    Balancer::powerOff();
+}
+
+void PowerDischargeStrategy::powerOn()
+{
+    Discharger::powerOn();
+    Balancer::powerOn();
+    endCount_ = 0;
+    gain_ = 256;
+}
+
+Strategy::statusType PowerDischargeStrategy::doStrategy()
+{
+    //the regulation runs once per full measurement (see Strategy::doStrategy)
+    if(TheveninDischargeStrategy::isEndVout()) {
+        if(++endCount_ >= endVoutCount) {
+            return Strategy::COMPLETE;
+        }
+    } else {
+        endCount_ = 0;
+    }
+
+    AnalogInputs::ValueType V = AnalogInputs::getVbattery();
+    if(V == 0) V = 1;
+    AnalogInputs::ValueType I = calculateI(V);
+    LogDebug("V=", V, " I=", I, " gain=", gain_);
+    Discharger::trySetIout(I);
+    return Strategy::RUNNING;
+}
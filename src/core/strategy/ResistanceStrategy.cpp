@@ -0,0 +1,152 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2016  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "Hardware.h"
+#include "ProgramData.h"
+#include "ResistanceStrategy.h"
+#include "Balancer.h"
+#include "TheveninMethod.h"
+#include "memory.h"
+
+//#define ENABLE_DEBUG
+#include "debug.h"
+
+/* DC internal resistance measurement:
+ * the battery is loaded with RESISTANCE_STRATEGY_STEPS discharge currents,
+ * at every step (after Iout and Vout are stable) all voltages are sampled
+ * from the same full measurement, R = -dV/dI (least squares)
+ */
+
+namespace ResistanceStrategy {
+    const Strategy::VTable vtable PROGMEM = {
+        powerOn,
+        powerOff,
+        doStrategy
+    };
+
+    //max. number of full measurements to wait for a stable current
+    const static uint8_t maxStepMeasurements = 8;
+
+    uint8_t step_;
+    uint8_t count_;
+    AnalogInputs::ValueType I_[RESISTANCE_STRATEGY_STEPS];
+    AnalogInputs::ValueType Vbatt_[RESISTANCE_STRATEGY_STEPS];
+    AnalogInputs::ValueType Vcell_[RESISTANCE_STRATEGY_STEPS][MAX_BALANCE_CELLS];
+
+    AnalogInputs::ValueType getStepI(uint8_t step) {
+        uint32_t I = ProgramData::battery.Id;
+        I *= step;
+        I /= RESISTANCE_STRATEGY_STEPS - 1;
+        return I;
+    }
+
+    void setStep(uint8_t step) {
+        step_ = step;
+        count_ = 0;
+        Discharger::trySetIout(getStepI(step));
+    }
+
+    void sample() {
+        I_[step_] = AnalogInputs::getIout();
+        Vbatt_[step_] = AnalogInputs::getVbattery();
+        for(uint8_t c = 0; c < MAX_BALANCE_CELLS; c++) {
+            Vcell_[step_][c] = Balancer::getV(c);
+        }
+        LogDebug("step=", step_, " I=", I_[step_], " V=", Vbatt_[step_]);
+    }
+
+    Resistance calculateR(const AnalogInputs::ValueType *V, uint8_t stride) {
+        //least squares slope of V(I)
+        int32_t avrI = 0;
+        for(uint8_t i = 0; i < RESISTANCE_STRATEGY_STEPS; i++) {
+            avrI += I_[i];
+        }
+        avrI /= RESISTANCE_STRATEGY_STEPS;
+        int32_t sumIV = 0, sumII = 0;
+        for(uint8_t i = 0; i < RESISTANCE_STRATEGY_STEPS; i++) {
+            int32_t dI = int32_t(I_[i]) - avrI;
+            sumIV += dI * V[i * stride];
+            sumII += dI * dI;
+        }
+        //R in mOhm: iV/uI with uI = 1A
+        Resistance R;
+        R.uI = ANALOG_AMP(1.0);
+        R.iV = 0;
+        sumII /= ANALOG_AMP(1.0);
+        if(sumII > 0) {
+            R.iV = sumIV / sumII;
+        }
+        return R;
+    }
+
+    void calculateResults() {
+        TheveninMethod::setBattRth(calculateR(Vbatt_, 1));
+        for(uint8_t c = 0; c < MAX_BALANCE_CELLS; c++) {
+            if(AnalogInputs::connectedBalancePortCells & (1<<c)) {
+                TheveninMethod::setRthCell(c, calculateR(&Vcell_[0][c], MAX_BALANCE_CELLS));
+            }
+        }
+    }
+}
+
+bool ResistanceStrategy::isDone()
+{
+    return step_ >= RESISTANCE_STRATEGY_STEPS;
+}
+
+void ResistanceStrategy::powerOff()
+{
+    Discharger::powerOff();
+}
+
+void ResistanceStrategy::powerOn()
+{
+    Discharger::powerOn();
+    setStep(0);
+}
+
+Strategy::statusType ResistanceStrategy::doStrategy()
+{
+    if(isDone())
+        return Strategy::COMPLETE;
+
+    count_++;
+    if(AnalogInputs::isOutStable() || count_ >= maxStepMeasurements) {
+        sample();
+        if(step_ + 1 < RESISTANCE_STRATEGY_STEPS
+                && Strategy::endV < AnalogInputs::getVbattery()) {
+            setStep(step_ + 1);
+        } else {
+            //done (or the battery is too low for the next step)
+            Discharger::powerOff();
+            if(step_ > 0) {
+                while(++step_ < RESISTANCE_STRATEGY_STEPS) {
+                    //repeat the last step, it does not change the least squares slope
+                    I_[step_] = I_[step_ - 1];
+                    Vbatt_[step_] = Vbatt_[step_ - 1];
+                    for(uint8_t c = 0; c < MAX_BALANCE_CELLS; c++) {
+                        Vcell_[step_][c] = Vcell_[step_ - 1][c];
+                    }
+                }
+                calculateResults();
+            }
+            step_ = RESISTANCE_STRATEGY_STEPS;
+            return Strategy::COMPLETE;
+        }
+    }
+    return Strategy::RUNNING;
+}
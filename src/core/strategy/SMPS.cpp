@@ -19,6 +19,8 @@
 #include "SMPS.h"
 #include "Program.h"
 #include "Settings.h"
+#include "Thermal.h"
+#include "InputPowerLimit.h"
 
 #ifndef SMPS_MAX_CURRENT_CHANGE
 #define SMPS_MAX_CURRENT_CHANGE     ANALOG_AMP(0.200)
@@ -57,9 +59,16 @@ namespace SMPS {
         }
 #endif
 
+#ifdef ENABLE_INPUT_POWER_LIMIT
+        AnalogInputs::ValueType i = AnalogInputs::evalI(InputPowerLimit::getMaxPc(), v);
+#else
         AnalogInputs::ValueType i = AnalogInputs::evalI(settings.maxPc, v);
+#endif
         if(i > settings.maxIc)
             i = settings.maxIc;
+#ifdef ENABLE_T_INTERNAL
+        i = Thermal::derate(i);
+#endif
         return i;
     }
 }
@@ -0,0 +1,219 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2016  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#define __STDC_LIMIT_MACROS
+#include "StateOfCharge.h"
+#include "ProgramData.h"
+#include "Strategy.h"
+#include "SMPS.h"
+#include "Discharger.h"
+#include "TheveninMethod.h"
+#include "memory.h"
+#include "Utils.h"
+
+//#define ENABLE_DEBUG
+#include "debug.h"
+
+/* One dimensional Kalman filter:
+ *  - prediction: coulomb counting (Cout)
+ *  - measurement: open circuit voltage table,
+ *      the battery voltage is compensated with the Thevenin Rth
+ */
+
+namespace StateOfCharge {
+
+    //Kalman filter variances in (0.01%)^2
+    const static uint32_t processNoise = 4;
+    const static uint32_t initialVariance = 500UL*500;
+    const static uint32_t maxVariance = 2000UL*2000;
+    //voltage measurement (and model) error per cell
+    const static AnalogInputs::ValueType ocvError = ANALOG_VOLT(0.010);
+    //max. Rth per cell, Rth from TheveninMethod is meaningless before the first current change
+    const static AnalogInputs::ValueType maxRthPerCell = ANALOG_OHM(0.050);
+
+    uint16_t soc_;
+    uint32_t variance_;
+    AnalogInputs::ValueType lastCout_;
+    uint16_t lastMeasurement_;
+
+    AnalogInputs::ValueType getRthDrop() {
+        //voltage drop on the battery internal resistance (pack)
+        uint16_t cells = ProgramData::battery.cells;
+        uint32_t R = TheveninMethod::getReadableBattRth();
+        if(R > uint32_t(maxRthPerCell) * cells)
+            R = uint32_t(maxRthPerCell) * cells;
+        R *= AnalogInputs::getIout();
+        R /= ANALOG_OHM(1.0);
+        return R;
+    }
+
+    AnalogInputs::ValueType getOcvPerCell(AnalogInputs::ValueType v) {
+        //v - loaded battery voltage
+        uint16_t cells = ProgramData::battery.cells;
+        if(cells == 0)
+            return 0;
+        if(SMPS::isPowerOn()) {
+            SUB_MIN(v, getRthDrop(), 0);
+        } else if(Discharger::isPowerOn()) {
+            ADD_MAX(v, getRthDrop(), UINT16_MAX);
+        }
+        return v / cells;
+    }
+
+    uint32_t getMeasurementVariance(uint16_t soc) {
+        //flat parts of the OCV curve carry little information
+        uint8_t i = soc / (STATE_OF_CHARGE_MAX / (STATE_OF_CHARGE_OCV_POINTS - 1));
+        if(i >= STATE_OF_CHARGE_OCV_POINTS - 1)
+            i = STATE_OF_CHARGE_OCV_POINTS - 2;
+        uint16_t dV = ProgramData::getOcvPoint(i + 1) - ProgramData::getOcvPoint(i);
+        if(dV == 0)
+            return maxVariance;
+        uint32_t sigma = ocvError;
+        sigma *= STATE_OF_CHARGE_MAX / (STATE_OF_CHARGE_OCV_POINTS - 1);
+        sigma /= dV;
+        sigma *= sigma;
+        if(sigma > maxVariance)
+            sigma = maxVariance;
+        return sigma;
+    }
+
+    uint32_t chargeToSoC(uint32_t charge) {
+        uint16_t c = ProgramData::battery.capacity;
+        if(c == 0)
+            return 0;
+        charge *= STATE_OF_CHARGE_MAX;
+        return charge / c;
+    }
+
+    uint32_t socToCharge(uint16_t soc) {
+        uint32_t charge = soc;
+        charge *= ProgramData::battery.capacity;
+        return charge / STATE_OF_CHARGE_MAX;
+    }
+
+    uint32_t getTime(uint32_t charge, AnalogInputs::ValueType I) {
+        //charge [mAh] with current I [mA] -> time [s]
+        if(I == 0)
+            return 0;
+        return charge * 3600 / I;
+    }
+}
+
+uint16_t StateOfCharge::getOcvSoC()
+{
+    return ProgramData::ocvToSoC(getOcvPerCell(AnalogInputs::getVbattery()));
+}
+
+uint16_t StateOfCharge::getSoC()
+{
+    return soc_;
+}
+
+uint8_t StateOfCharge::getProcent()
+{
+    return soc_ / (STATE_OF_CHARGE_MAX / 100);
+}
+
+void StateOfCharge::initialize()
+{
+    soc_ = getOcvSoC();
+    variance_ = initialVariance;
+    resetCharge();
+}
+
+void StateOfCharge::resetCharge()
+{
+    lastCout_ = 0;
+    lastMeasurement_ = AnalogInputs::getFullMeasurementCount();
+}
+
+void StateOfCharge::doMeasurement()
+{
+    uint16_t m = AnalogInputs::getFullMeasurementCount();
+    if(m == lastMeasurement_)
+        return;
+    lastMeasurement_ = m;
+
+    //prediction - coulomb counting
+    AnalogInputs::ValueType c = AnalogInputs::getRealValue(AnalogInputs::Cout);
+    int32_t soc = soc_;
+    if(c < lastCout_) {
+        //Cout was reset, nothing to count
+        lastCout_ = c;
+    } else {
+        uint32_t dSoC = chargeToSoC(c - lastCout_);
+        if(dSoC) {
+            lastCout_ = c;
+            if(SMPS::isPowerOn()) soc += dSoC;
+            else if(Discharger::isPowerOn()) soc -= dSoC;
+        }
+    }
+    variance_ += processNoise;
+
+    //measurement - OCV
+    uint16_t z = getOcvSoC();
+    uint32_t R = getMeasurementVariance(z);
+    uint16_t K = variance_ * 256 / (variance_ + R);
+    soc += (int32_t(z) - soc) * K / 256;
+    variance_ = variance_ * (256 - K) / 256;
+    if(variance_ > maxVariance) variance_ = maxVariance;
+
+    if(soc < 0) soc = 0;
+    if(soc > STATE_OF_CHARGE_MAX) soc = STATE_OF_CHARGE_MAX;
+    soc_ = soc;
+    LogDebug("soc=", soc_, " z=", z, " K=", K);
+}
+
+uint32_t StateOfCharge::getETATime()
+{
+    AnalogInputs::ValueType I = AnalogInputs::getIout();
+    if(I == 0 || ProgramData::battery.capacity == 0 || ProgramData::battery.cells == 0)
+        return 0;
+
+    //SoC at which the (Rth compensated) voltage reaches endV
+    AnalogInputs::ValueType endV = Strategy::endV;
+    if(SMPS::isPowerOn()) {
+        SUB_MIN(endV, getRthDrop(), 0);
+    } else {
+        ADD_MAX(endV, getRthDrop(), UINT16_MAX);
+    }
+    uint16_t socEnd = ProgramData::ocvToSoC(endV / ProgramData::battery.cells);
+
+    if(!SMPS::isPowerOn()) {
+        //constant current discharge
+        if(soc_ <= socEnd)
+            return 0;
+        return getTime(socToCharge(soc_ - socEnd), I);
+    }
+
+    //charge: constant current up to socEnd, then constant voltage:
+    //I(t) = I*exp(-t/tau) until I(t) = minI
+    //charge in CV phase: q = tau*(I - minI)  =>  t = q/(I - minI)*ln(I/minI)
+    uint32_t t = 0;
+    uint16_t socCV = soc_;
+    if(soc_ < socEnd) {
+        t = getTime(socToCharge(socEnd - soc_), I);
+        socCV = socEnd;
+        I = max(I, Strategy::maxI);
+    }
+    AnalogInputs::ValueType minI = Strategy::minI;
+    if(I > minI) {
+        uint32_t q = socToCharge(STATE_OF_CHARGE_MAX - socCV);
+        t += getTime(q, I - minI) * ln256(I, minI) / 256;
+    }
+    return t;
+}
@@ -0,0 +1,41 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2016  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef STATEOFCHARGE_H_
+#define STATEOFCHARGE_H_
+
+#include "AnalogInputs.h"
+#include "ProgramData.h"
+
+#define STATE_OF_CHARGE_OCV_POINTS   CHEMISTRY_OCV_POINTS // 0%, 10%, .., 100%
+#define STATE_OF_CHARGE_MAX          CHEMISTRY_SOC_MAX // 100.00%
+
+namespace StateOfCharge {
+
+    //state of charge in 0.01% units
+    uint16_t getSoC();
+    uint8_t getProcent();
+    //state of charge based only on the (Rth compensated) battery voltage
+    uint16_t getOcvSoC();
+    uint32_t getETATime();
+
+    void initialize();
+    void resetCharge();
+    void doMeasurement();
+};
+
+#endif /* STATEOFCHARGE_H_ */
@@ -23,6 +23,7 @@
 #include "Monitor.h"
 #include "AnalogInputs.h"
 #include "Screen.h"
+#include "Profile.h"
 
 #define STRATEGY_DISABLE_OUTPUT_AFTER_SECONDS (3*60)
 
@@ -120,7 +121,8 @@ namespace Strategy {
         Strategy::statusType status = Strategy::RUNNING;
         strategyPowerOn();
         do {
-            Screen::keyboardButton =  Keyboard::getPressedWithDelay();
+            Time::doIdle();
+            Screen::keyboardButton =  Keyboard::getPressed();
             Screen::doStrategy();
 
             if(run) {
@@ -129,6 +131,7 @@ namespace Strategy {
 
                 if(run && newMesurmentData != AnalogInputs::getFullMeasurementCount()) {
                     newMesurmentData = AnalogInputs::getFullMeasurementCount();
+                    PROFILE_ZONE(Strategy);
                     status = strategyDoStrategy();
                     run = analizeStrategyStatus(status);
                 }
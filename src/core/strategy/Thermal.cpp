@@ -0,0 +1,200 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2016  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "Thermal.h"
+#include "Settings.h"
+#include "Hardware.h"
+#include "Time.h"
+
+//#define ENABLE_DEBUG
+#include "debug.h"
+
+namespace Thermal {
+    uint16_t lastUpdate_;
+    AnalogInputs::ValueType windowT_;
+    uint8_t windowCount_;
+    //dT/dt in 1/16 ANALOG_CELCIUS per second
+    int16_t slope_;
+    AnalogInputs::ValueType predictedT_;
+    uint16_t derating_;
+
+#ifdef ENABLE_THERMAL_FAN
+    //in 1/16 of the duty
+    int16_t integral_;
+    uint8_t fanPI_;
+    volatile uint8_t fan_;
+    uint8_t fanSum_;
+
+    void updateFanPI() {
+        int16_t e = predictedT_ - settings.fanTempOn;
+        int16_t duty = e/2 + integral_/16;
+
+        //anti windup - integrate only when not saturated
+        if((e > 0 && duty < THERMAL_FAN_MAX) || (e < 0 && duty > 0)) {
+            integral_ += e/4;
+            if(integral_ < 0) integral_ = 0;
+            if(integral_ > THERMAL_FAN_MAX*16) integral_ = THERMAL_FAN_MAX*16;
+        }
+
+        if(duty < THERMAL_FAN_MIN/2) {
+            duty = 0;
+        } else if(duty < THERMAL_FAN_MIN) {
+            duty = THERMAL_FAN_MIN;
+        } else if(duty > THERMAL_FAN_MAX || derating_ < THERMAL_DERATING_MAX) {
+            duty = THERMAL_FAN_MAX;
+        }
+        fanPI_ = duty;
+    }
+#endif
+
+    void updateDerating() {
+        //linear derating: THERMAL_DERATING_MAX at (dischargeTempOff - 2*TempDifference)
+        //down to 0 at the dischargeTempOff cutoff
+        const AnalogInputs::ValueType window = 2*Settings::TempDifference;
+        AnalogInputs::ValueType limit = settings.dischargeTempOff;
+        AnalogInputs::ValueType t = AnalogInputs::getRealValue(AnalogInputs::Tintern);
+        if(t < predictedT_) t = predictedT_;
+
+        uint16_t d;
+        if(t >= limit) {
+            d = 0;
+        } else if(t + window <= limit) {
+            d = THERMAL_DERATING_MAX;
+        } else {
+            uint32_t x = limit - t;
+            x *= THERMAL_DERATING_MAX;
+            d = x / window;
+        }
+        //go down fast, recover slowly
+        if(d > derating_) {
+            d = (derating_ * 3 + d + 3) / 4;
+        }
+        derating_ = d;
+    }
+
+    void update() {
+        AnalogInputs::ValueType t = AnalogInputs::getRealValue(AnalogInputs::Tintern);
+        if(windowT_ == 0) {
+            //no slope from the first measurement
+            windowT_ = t;
+            windowCount_ = 0;
+        } else if(++windowCount_ >= THERMAL_SLOPE_WINDOW) {
+            int32_t s = int32_t(t) - windowT_;
+            s *= 16;
+            s /= THERMAL_SLOPE_WINDOW;
+            windowT_ = t;
+            windowCount_ = 0;
+            //low pass filter of dT/dt, saturated (sensor glitches)
+            s = slope_ + (s - slope_) / 4;
+            if(s > THERMAL_SLOPE_MAX) s = THERMAL_SLOPE_MAX;
+            if(s < -THERMAL_SLOPE_MAX) s = -THERMAL_SLOPE_MAX;
+            slope_ = s;
+        }
+
+        int32_t p = slope_;
+        p *= THERMAL_TAU_SECONDS;
+        p /= 16;
+        p += t;
+        if(p < 0) p = 0;
+        if(p > ANALOG_CELCIUS(150)) p = ANALOG_CELCIUS(150);
+        predictedT_ = p;
+
+        updateDerating();
+#ifdef ENABLE_THERMAL_FAN
+        updateFanPI();
+#endif
+        LogDebug("T=", t, " Tp=", predictedT_, " derating=", derating_);
+    }
+}
+
+void Thermal::initialize()
+{
+    lastUpdate_ = Time::getMilisecondsU16();
+    windowT_ = 0;
+    predictedT_ = 0;
+    slope_ = 0;
+    derating_ = THERMAL_DERATING_MAX;
+#ifdef ENABLE_THERMAL_FAN
+    integral_ = 0;
+    fanPI_ = 0;
+#endif
+}
+
+void Thermal::doIdle()
+{
+    uint16_t t = Time::getMilisecondsU16();
+    if(Time::diffU16(lastUpdate_, t) >= THERMAL_UPDATE_PERIOD_MILISECONDS) {
+        lastUpdate_ = t;
+        update();
+    }
+}
+
+AnalogInputs::ValueType Thermal::getPredictedT()
+{
+    return predictedT_;
+}
+
+uint16_t Thermal::getDerating()
+{
+    return derating_;
+}
+
+AnalogInputs::ValueType Thermal::derate(AnalogInputs::ValueType I)
+{
+    uint32_t i = I;
+    i *= derating_;
+    i /= THERMAL_DERATING_MAX;
+    return i;
+}
+
+#ifdef ENABLE_THERMAL_FAN
+
+uint8_t Thermal::getFanPI()
+{
+    return fanPI_;
+}
+
+uint8_t Thermal::getFan()
+{
+    return fan_;
+}
+
+void Thermal::setFan(uint8_t duty)
+{
+    fan_ = duty;
+}
+
+void Thermal::doInterrupt()
+{
+    static uint8_t interval = THERMAL_FAN_INTERRUPT_INTERVAL;
+    if(--interval) return;
+    interval = THERMAL_FAN_INTERRUPT_INTERVAL;
+
+    //sigma-delta modulation of the fan pin
+    uint8_t duty = fan_;
+    bool on;
+    if(duty == THERMAL_FAN_MAX) {
+        on = true;
+    } else {
+        uint8_t sum = fanSum_ + duty;
+        on = sum < fanSum_;
+        fanSum_ = sum;
+    }
+    hardware::setFan(on);
+}
+
+#endif
@@ -0,0 +1,67 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2016  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef THERMAL_H_
+#define THERMAL_H_
+
+#include "AnalogInputs.h"
+
+#if defined(ENABLE_FAN) && defined(ENABLE_T_INTERNAL)
+#define ENABLE_THERMAL_FAN
+#endif
+
+#define THERMAL_UPDATE_PERIOD_MILISECONDS   1000
+//dTintern/dt is the difference over this many updates (the sensor steps are too coarse for 1s)
+#define THERMAL_SLOPE_WINDOW                30
+//max. |dTintern/dt| in 1/16 ANALOG_CELCIUS per second (1 C/s)
+#define THERMAL_SLOPE_MAX                   (ANALOG_CELCIUS(1)*16)
+//heatsink time constant
+#ifndef THERMAL_TAU_SECONDS
+#define THERMAL_TAU_SECONDS                 120
+#endif
+
+#define THERMAL_DERATING_MAX                256
+#define THERMAL_FAN_MAX                     255
+//the fan stalls below this duty
+#ifndef THERMAL_FAN_MIN
+#define THERMAL_FAN_MIN                     64
+#endif
+//fan PWM period = 256 * THERMAL_FAN_INTERRUPT_INTERVAL * TIMER_INTERRUPT_PERIOD_MICROSECONDS
+#define THERMAL_FAN_INTERRUPT_INTERVAL      8
+
+//first order thermal model of the internal heatsink:
+//Tpredicted = Tintern + tau * dTintern/dt (the steady state temperature)
+//is used to derate the charge and discharge current before the dischargeTempOff cutoff
+namespace Thermal {
+    void initialize();
+    void doIdle();
+
+    AnalogInputs::ValueType getPredictedT();
+    //0 - THERMAL_DERATING_MAX
+    uint16_t getDerating();
+    AnalogInputs::ValueType derate(AnalogInputs::ValueType I);
+
+#ifdef ENABLE_THERMAL_FAN
+    //PI controller on Tintern, 0 - THERMAL_FAN_MAX
+    uint8_t getFanPI();
+    void setFan(uint8_t duty);
+    uint8_t getFan();
+    void doInterrupt();
+#endif
+};
+
+#endif /* THERMAL_H_ */
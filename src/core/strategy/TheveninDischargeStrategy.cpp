@@ -32,7 +32,6 @@ namespace TheveninDischargeStrategy {
     };
 
     bool endOnTheveninMethodComplete_;
-    bool isEndVout();
 
 }
 
@@ -59,6 +58,10 @@ Strategy::statusType TheveninDischargeStrategy::doStrategy()
     bool isendVout = isEndVout();
     AnalogInputs::ValueType I = Discharger::getIout();
 
+#ifdef ENABLE_BALANCER_DISCHARGE
+    Balancer::doAuxDischarge(!isendVout);
+#endif
+
     //test for charge complete
     bool end = isendVout;
     if(endOnTheveninMethodComplete_) {
@@ -28,6 +28,7 @@ namespace TheveninDischargeStrategy
     void powerOn();
     Strategy::statusType doStrategy();
     void powerOff();
+    bool isEndVout();
 
 };
 
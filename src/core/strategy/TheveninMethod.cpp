@@ -69,6 +69,8 @@ namespace TheveninMethod {
 
 AnalogInputs::ValueType TheveninMethod::getReadableRthCell(uint8_t cell) { return tBal_[cell].Rth.getReadableRth(); }
 AnalogInputs::ValueType TheveninMethod::getReadableBattRth()             { return tVout_.Rth.getReadableRth(); }
+void TheveninMethod::setRthCell(uint8_t cell, Resistance R)   { tBal_[cell].Rth = R; }
+void TheveninMethod::setBattRth(Resistance R)                   { tVout_.Rth = R; }
 AnalogInputs::ValueType TheveninMethod::getReadableWiresRth()
 {
     Resistance R;
@@ -142,9 +144,9 @@ AnalogInputs::ValueType TheveninMethod::calculateNewI(bool isEndVout, AnalogInpu
     //update when output is stable or end voltage reached
     bool updateI = AnalogInputs::isOutStable() || (isEndVout && newI_ != 0);
 
-    //update only when we are not balancing:
-    //- on PowerB6 Balancer::getPresumedV is not stable enough
-    updateI = updateI && !Balancer::isWorking();
+    //while balancing update only when the cell voltages can be
+    //compensated for the bleed current (see Balancer::getLeadDrop)
+    updateI = updateI && Balancer::isPresumedVValid();
 
     if(updateI) {
 
@@ -32,6 +32,10 @@ namespace TheveninMethod {
     AnalogInputs::ValueType getReadableRthCell(uint8_t cell);
     AnalogInputs::ValueType getReadableBattRth();
     AnalogInputs::ValueType getReadableWiresRth();
+
+    //store an externally measured resistance (see ResistanceStrategy)
+    void setRthCell(uint8_t cell, Resistance R);
+    void setBattRth(Resistance R);
 };
 
 
@@ -6,6 +6,10 @@ set(CORE_SOURCE
     DelayStrategy.cpp        Discharger.h           SimpleDischargeStrategy.cpp  StartInfoStrategy.h    TheveninChargeStrategy.cpp  Thevenin.h
     DelayStrategy.h          Monitor.cpp            SimpleDischargeStrategy.h    StorageStrategy.cpp    TheveninChargeStrategy.h    TheveninMethod.cpp
     DeltaChargeStrategy.cpp  Monitor.h              SMPS.cpp                     StorageStrategy.h      Thevenin.cpp                TheveninMethod.h
+    StateOfCharge.cpp        StateOfCharge.h        ResistanceStrategy.cpp       ResistanceStrategy.h
+    PowerDischargeStrategy.cpp   PowerDischargeStrategy.h
+    Thermal.cpp                  Thermal.h
+    InputPowerLimit.cpp          InputPowerLimit.h
 )
 
 CHEALI_ADD("CORE_SOURCE_FILES" "${CORE_SOURCE}")
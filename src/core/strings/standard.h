@@ -62,6 +62,8 @@ namespace ProgramMenus {
     STRING(storageAndBalance,   "storage+balanc");
     STRING(dcCycle,             "D>C format");
     STRING(capacityCheck,       "capacity check");
+    STRING(measureResistance,   "measure R");
+    STRING(sequence,            "sequence");
     STRING(editBattery,         "edit battery");
 }
 
@@ -155,6 +157,12 @@ namespace ProgramDataMenu {
     STRING(minIc,       "minIc:");
     STRING(Id,          "Id:");
     STRING(minId,       "minId:");
+    STRING(dischargeMode,       "dis mode:");
+    STRING(dischargeCurrent,    "I");
+    STRING(dischargePower,      "P");
+    STRING(dischargeResistance, "R");
+    STRING(dischargeP,  "|Pd:");
+    STRING(dischargeR,  "|Rd:");
     STRING(balancErr,   "bal. err:");
 
     STRING(enabledV,    "enab dV:");
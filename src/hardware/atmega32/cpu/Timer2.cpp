@@ -45,3 +45,19 @@ void Time::initialize()
 
     TIMSK|=(1<<OCIE2);              //OCIE2: Timer/Counter2 Output Compare Match Interrupt Enable
 }
+
+uint32_t Time::getMicroseconds()
+{
+    uint32_t i;
+    uint8_t t;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        i = getInterrupts();
+        t = TCNT2;
+        if(TIFR & (1<<OCF2)) {
+            //compare match pending, the counter has already been cleared
+            i++;
+            t = TCNT2;
+        }
+    }
+    return i * TIMER_INTERRUPT_PERIOD_MICROSECONDS + t * 4;
+}
@@ -20,4 +20,9 @@
 
 #include <util/atomic.h>
 
+static __inline__ bool interruptsEnabled(void)
+{
+    return SREG & (1 << SREG_I);
+}
+
 #endif /* ATOMIC_H_ */
@@ -162,7 +162,7 @@ namespace eeprom {
     template<class Type>
     struct write_impl<Type, 1> {
         inline void operator()(Type * addressE, const Type &t) {
-            eeprom_update_byte((const uint8_t*) addressE, t);
+            eeprom_update_byte((uint8_t*) addressE, t);
         }
     };
 
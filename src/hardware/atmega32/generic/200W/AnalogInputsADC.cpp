@@ -26,6 +26,7 @@
 #include "IO.h"
 #include "Settings.h"
 #include "AnalogInputsPrivate.h"
+#include "Monitor.h"
 
 //#define ENABLE_DEBUG
 #include "debug.h"
@@ -240,6 +241,9 @@ void conversionDone()
     //ignore first 3 measurements, ADC channel needs to stabilize
     if(g_adcBurstCount_ > 2) {
         processConversion(v);
+#ifdef ENABLE_FAST_TRIP
+        Monitor::fastTrip(adc_input.ai_name, v);
+#endif
     }
 
 #ifdef ENABLE_DEBUG
@@ -35,6 +35,8 @@
 #define ENABLE_FAN
 #define ENABLE_T_INTERNAL
 #define ENABLE_STACK_INFO
+//cut the outputs from the ADC interrupt (see Monitor::fastTrip)
+#define ENABLE_FAST_TRIP
 #define ENABLE_EXPERT_VOLTAGE_CALIBRATION
 
 #define ANALOG_INPUTS_ADC_RESOLUTION_BITS   10
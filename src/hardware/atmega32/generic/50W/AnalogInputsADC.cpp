@@ -27,6 +27,7 @@
 #include "Settings.h"
 #include "Timer0.h"
 #include "AnalogInputsPrivate.h"
+#include "Monitor.h"
 #include "IO.h"
 #include "SMPS.h"
 #include "Discharger.h"
@@ -219,6 +220,9 @@ void conversionDone()
     //ignore first 2 measurements, ADC channel needs to stabilize
     if(g_adcBurstCount_ > 1) {
         processConversion(v);
+#ifdef ENABLE_FAST_TRIP
+        Monitor::fastTrip(adc_input.ai_name, v);
+#endif
     }
 
 #ifdef ENABLE_DEBUG
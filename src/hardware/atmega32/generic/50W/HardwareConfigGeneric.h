@@ -37,6 +37,8 @@
 //This is why we see a bigger Vb1 resistance.
 #define ENABLE_B0_DISCHARGE_VOLTAGE_CORRECTION
 #define ENABLE_STACK_INFO
+//cut the outputs from the ADC interrupt (see Monitor::fastTrip)
+#define ENABLE_FAST_TRIP
 #define ENABLE_GET_PID_VALUE
 #define ENABLE_EXPERT_VOLTAGE_CALIBRATION
 
@@ -23,7 +23,7 @@
 #include "SerialLog.h"
 #include "IO.h"
 #include "Keyboard.h"
-#include "LiquidCrystal.h"
+#include "LcdBackend.h"
 
 
 #ifndef PINS_H_
@@ -75,8 +75,8 @@ void hardware::initializePins()
 
 void hardware::initialize()
 {
-    LiquidCrystal::init();
-    LiquidCrystal::begin(LCD_COLUMNS, LCD_LINES);
+    LcdBackend::init();
+    LcdBackend::begin(LCD_COLUMNS, LCD_LINES);
 
     Timer0::initialize();
     Timer1::initialize();
@@ -20,7 +20,7 @@
 #include "adc.h"
 #include "IO.h"
 #include "Timer0.h"
-#include "LiquidCrystal.h"
+#include "LcdBackend.h"
 
 #ifndef PINS_H_
 #error pins not defined (include *pins.h header in your HardwareConfig.h)
@@ -61,8 +61,8 @@ void hardware::initializePins()
 
 void hardware::initialize()
 {
-    LiquidCrystal::init();
-    LiquidCrystal::begin(LCD_COLUMNS, LCD_LINES);
+    LcdBackend::init();
+    LcdBackend::begin(LCD_COLUMNS, LCD_LINES);
     Timer0::initialize();
     Timer1::initialize();
     adc::initialize();
@@ -23,6 +23,8 @@
 
 #undef  MAX_BALANCE_CELLS
 #define MAX_BALANCE_CELLS 8
+//the 1kB eeprom has less space left for the sequencer with 8 balance ports
+#define SEQUENCER_PROGRAM_SIZE 14
 
 #define LCD_D3_PIN              22
 #define LCD_D2_PIN              21
@@ -18,6 +18,7 @@
 #include "Time.h"
 #include "Hardware.h"
 #include "irq_priority.h"
+#include "atomic.h"
 
 extern "C" {
 #include "M051Series.h"
@@ -39,9 +40,25 @@ void Time::initialize()
     CLK_EnableModuleClock(TMR0_MODULE);
     CLK_SetModuleClock(TMR0_MODULE,CLK_CLKSEL1_TMR0_S_HCLK,CLK_CLKDIV_UART(1));
     TIMER_Open(TIMER0, TIMER_PERIODIC_MODE, 1000000/TIMER_INTERRUPT_PERIOD_MICROSECONDS);
+    TIMER0->TCSR |= TIMER_TCSR_TDR_EN_Msk;      //see getMicroseconds
     TIMER_EnableInt(TIMER0);
     NVIC_EnableIRQ(TMR0_IRQn);
     NVIC_SetPriority(TMR0_IRQn, TIMER_IRQ_PRIORITY);
     TIMER_Start(TIMER0);             /* Start counting */
 
 }
+
+uint32_t Time::getMicroseconds()
+{
+    uint32_t i, t;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        i = getInterrupts();
+        t = TIMER_GetCounter(TIMER0);
+        if(TIMER_GetIntFlag(TIMER0)) {
+            //time-out pending, the counter has already been cleared
+            i++;
+            t = TIMER_GetCounter(TIMER0);
+        }
+    }
+    return i * TIMER_INTERRUPT_PERIOD_MICROSECONDS + t * TIMER_INTERRUPT_PERIOD_MICROSECONDS / TIMER0->TCMPR;
+}
@@ -42,6 +42,11 @@ static __inline__ void __iRestore(uint8_t *__s)
 }
 
 
+static __inline__ bool interruptsEnabled(void)
+{
+    return __get_PRIMASK() == 0;
+}
+
 #define ATOMIC_BLOCK(type) for ( type = __iCliRetVal(), __ToDo =1; \
                            __ToDo ; __ToDo = 0 )
 
@@ -36,6 +36,17 @@
 //This is why we see a bigger Vb1 resistance.
 #define ENABLE_B0_DISCHARGE_VOLTAGE_CORRECTION
 #define ENABLE_STACK_INFO
+//use the balancer loads as an additional discharge load
+#define ENABLE_BALANCER_DISCHARGE
+
+//optional features, off on the atmega32 chargers (flash), see GlobalConfig.h
+#define ENABLE_INPUT_POWER_LIMIT
+#define ENABLE_STATE_OF_CHARGE
+#define ENABLE_POWER_DISCHARGE
+#define ENABLE_PROGRAM_MEASURE_R
+#define ENABLE_PROGRAM_SEQUENCE
+#define ENABLE_LCD_ASYNC
+#define ENABLE_LCD_GLYPHS
 
 #define ENABLE_EXT_TEMP_AND_UART_COMMON_OUTPUT
 
@@ -22,7 +22,7 @@
 #include "IO.h"
 #include "Keyboard.h"
 #include "outputPWM.h"
-#include "LiquidCrystal.h"
+#include "LcdBackend.h"
 
 #ifndef PINS_H_
 #error pins not defined (include *pins.h header in your HardwareConfig.h)
@@ -74,8 +74,8 @@ void hardware::initializePins()
 
 void hardware::initialize()
 {
-    LiquidCrystal::init();
-    LiquidCrystal::begin(LCD_COLUMNS, LCD_LINES);
+    LcdBackend::init();
+    LcdBackend::begin(LCD_COLUMNS, LCD_LINES);
     AnalogInputsADC::initialize();
     outputPWM::initialize();
     setVoutCutoff(MAX_CHARGE_V);
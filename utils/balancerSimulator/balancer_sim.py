@@ -0,0 +1,204 @@
+#!/usr/bin/python
+# -*- coding: utf-8 -*-
+#
+# Host simulation of the cell balancer (src/core/strategy/Balancer.cpp).
+#
+# Compares the "bleed every cell above minCell for 15s" rounds with the
+# predictive plan (charge excess -> per cell bleed time -> PWM duty).
+# The pack is at rest (Balance program), the simulation runs with the
+# firmware measurement period and reports the number of balancing rounds
+# and the time until the open circuit voltage spread of the cells is within
+# balancerError.
+#
+# usage: balancer_sim.py [cells] [capacity_mAh] [max_soc_mismatch_%]
+
+from __future__ import print_function
+import sys
+import random
+
+MEASUREMENT_PERIOD = 0.7        # s, one full AnalogInputs measurement
+STABLE_VALUE_ERROR = 0.006      # V
+STABLE_MIN_VALUE = 3
+START_STABLE_COUNT = 6          # Balancer::balancerStartStableCount
+MAX_BALANCE_TIME = 15           # s, Balancer::maxBalanceTime
+MAX_PLAN_TIME = 3600            # s, Balancer::maxPlanTime
+BALANCER_I = 0.160              # A
+BALANCER_R = 4.2 / BALANCER_I   # bleed resistor, Ohm
+PWM_STEPS = 16
+FULL_DUTY_ERROR = 0.030         # V, Balancer::fullDutyError
+BALANCER_ERROR = 0.008          # V, default battery.balancerError
+
+# LiPo ProgramData voltsPerCell: VCharged, VvalidEmpty
+V_CHARGED = 4.200
+V_VALID_EMPTY = 3.000
+
+# open circuit voltage of a LiPo cell (soc 0..1)
+OCV = [(0.00, 3.00), (0.05, 3.45), (0.10, 3.60), (0.20, 3.70), (0.40, 3.78),
+       (0.60, 3.87), (0.80, 4.00), (0.90, 4.08), (1.00, 4.20)]
+
+
+def ocv(soc):
+    soc = min(max(soc, 0.0), 1.0)
+    for (s0, v0), (s1, v1) in zip(OCV, OCV[1:]):
+        if soc <= s1:
+            return v0 + (v1 - v0) * (soc - s0) / (s1 - s0)
+    return OCV[-1][1]
+
+
+class Cell(object):
+    def __init__(self, capacity, soc, rng):
+        self.capacity = capacity * rng.uniform(0.97, 1.03)   # Ah
+        self.soc = soc
+        self.Rint = rng.uniform(0.004, 0.008)
+        self.Rp = rng.uniform(0.010, 0.020)                  # polarization
+        self.tau = rng.uniform(15.0, 40.0)
+        self.Vp = 0.0
+
+    def step(self, I, dt):
+        # I > 0 - discharge
+        self.soc -= I * dt / 3600.0 / self.capacity
+        self.Vp += (I * self.Rp - self.Vp) * min(dt / self.tau, 1.0)
+
+    def voltage(self, I):
+        return ocv(self.soc) - I * self.Rint - self.Vp
+
+
+class Pack(object):
+    def __init__(self, cells, capacity, mismatch, seed):
+        rng = random.Random(seed)
+        base = 0.60
+        self.cells = [Cell(capacity, base + rng.uniform(0, mismatch), rng)
+                      for _ in range(cells)]
+        self.rng = rng
+        self.Rlead = [rng.uniform(0.015, 0.040) for _ in range(cells + 1)]
+        self.duty = [0] * cells
+        self.stable = [0] * cells
+        self.last = [0.0] * cells
+        self.time = 0.0
+
+    def bleed(self, c):
+        return 4.0 / BALANCER_R * self.duty[c] / PWM_STEPS
+
+    def measure(self):
+        # one full measurement: the pack evolves, the ADC averages over PWM
+        steps = 7
+        dt = MEASUREMENT_PERIOD / steps
+        for _ in range(steps):
+            for c, cell in enumerate(self.cells):
+                cell.step(self.bleed(c), dt)
+        self.time += MEASUREMENT_PERIOD
+        n = len(self.cells)
+        V = []
+        for c, cell in enumerate(self.cells):
+            v = cell.voltage(self.bleed(c))
+            # balance lead drop (see Balancer::getLeadDrop)
+            lead_low = (self.bleed(c - 1) if c > 0 else 0) - self.bleed(c)
+            lead_high = self.bleed(c) - (self.bleed(c + 1) if c + 1 < n else 0)
+            v += self.Rlead[c] * lead_low - self.Rlead[c + 1] * lead_high
+            v = round(v + self.rng.gauss(0, 0.0007), 3)
+            if abs(v - self.last[c]) > STABLE_VALUE_ERROR:
+                self.stable[c] = 0
+            else:
+                self.stable[c] += 1
+            self.last[c] = v
+            V.append(v)
+        return V
+
+    def set_duty(self, duty):
+        self.duty = list(duty)
+        self.stable = [0] * len(self.cells)
+
+    def is_stable(self, count):
+        return min(self.stable) >= count
+
+    def spread(self):
+        v = [ocv(c.soc) for c in self.cells]
+        return max(v) - min(v)
+
+
+def bleed_time(excess, capacity_mAh):
+    dV = V_CHARGED - V_VALID_EMPTY
+    if excess >= dV:
+        return MAX_PLAN_TIME
+    t = excess / dV * capacity_mAh * 3.6 / BALANCER_I
+    return min(t, MAX_PLAN_TIME)
+
+
+def run(pack, capacity_mAh, planner, max_time=6 * 3600):
+    rounds = 0
+    V = pack.measure()
+    while pack.time < max_time:
+        V = pack.measure()
+        # Balancer::startBalacing
+        if not pack.is_stable(START_STABLE_COUNT):
+            continue
+        if pack.spread() <= BALANCER_ERROR:
+            return rounds, pack.time
+        vmin = min(V)
+        if max(V) == vmin:
+            continue
+        Voff = list(V)
+        excess = [v - vmin for v in V]
+        if planner:
+            t = [bleed_time(e, capacity_mAh) if e > 0 else 0 for e in excess]
+            plan = max(t)
+            if plan <= MAX_BALANCE_TIME:
+                plan = 0
+        else:
+            plan = 0
+        if plan:
+            duty = [max(1, int(ti * PWM_STEPS / plan)) if e > 0 else 0
+                    for ti, e in zip(t, excess)]
+            round_time = plan
+        else:
+            duty = [PWM_STEPS if e > 0 else 0 for e in excess]
+            if planner:
+                duty = [min(PWM_STEPS, max(1, int(e * PWM_STEPS / FULL_DUTY_ERROR)))
+                        if e > 0 else 0 for e in excess]
+            round_time = MAX_BALANCE_TIME
+        pack.set_duty(duty)
+        rounds += 1
+        start = pack.time
+        Von = None
+        while pack.time - start <= round_time:
+            V = pack.measure()
+            if Von is None:
+                if pack.is_stable(STABLE_MIN_VALUE):
+                    Von = list(V)
+                continue
+            if plan:
+                # Balancer::isPlanError
+                P = [v + off - on for v, off, on in zip(V, Voff, Von)]
+                pmin = P[excess.index(0.0)]
+                if any(duty[c] and (P[c] + BALANCER_ERROR < pmin
+                                    or P[c] > pmin + excess[c] + 2 * BALANCER_ERROR)
+                       for c in range(len(P))):
+                    break
+        pack.set_duty([0] * len(duty))
+    return rounds, pack.time
+
+
+def main():
+    cells = int(sys.argv[1]) if len(sys.argv) > 1 else 6
+    capacity = int(sys.argv[2]) if len(sys.argv) > 2 else 2200
+    mismatch = float(sys.argv[3]) / 100 if len(sys.argv) > 3 else 0.05
+
+    print("cells: %d, capacity: %dmAh, SoC mismatch up to %.1f%%"
+          % (cells, capacity, mismatch * 100))
+    print("%-6s %-22s %-22s" % ("seed", "15s rounds", "planner"))
+    total = [0.0, 0.0]
+    seeds = range(10)
+    for seed in seeds:
+        result = []
+        for i, planner in enumerate((False, True)):
+            pack = Pack(cells, capacity / 1000.0, mismatch, seed)
+            rounds, t = run(pack, capacity, planner)
+            total[i] += t
+            result.append("%4d rounds %7.1fmin" % (rounds, t / 60))
+        print("%-6d %-22s %-22s" % (seed, result[0], result[1]))
+    print("average time: %.1fmin vs %.1fmin"
+          % (total[0] / 60 / len(seeds), total[1] / 60 / len(seeds)))
+
+
+if __name__ == '__main__':
+    main()
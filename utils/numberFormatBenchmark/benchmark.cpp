@@ -0,0 +1,167 @@
+/*
+ * host micro-benchmark of src/core/drivers/PrintNumber.cpp
+ * against the old division based printLong (LcdPrint.cpp)
+ *
+ * usage:
+ *   g++ -O2 -I. benchmark.cpp -o benchmark && ./benchmark
+ *
+ * The host has a hardware divider (and gcc turns /10 into a multiplication),
+ * so the measured host cycles favour the old code. The AVR numbers are
+ * a cycle model: the old code does 2 __divmodsi4 calls per digit (digits()
+ * and the print loop), the new one a progmem read and compare/subtract
+ * steps per power of ten.
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_RDTSC
+#endif
+
+#include "../../src/core/drivers/PrintNumber.cpp"
+
+namespace old {
+    uint8_t digits(int32_t x)
+    {
+        uint8_t retu = 0;
+        if(x < 0) {
+            retu++;
+            x = -x;
+        }
+        if(x == 0)
+            retu=1;
+        for(;x!=0; x/=10)
+            retu++;
+        return retu;
+    }
+
+    char* printLong(int32_t value, char * buf) {
+        char * end;
+        if (value < 0) {
+            *(buf++)='-';
+            value = -value;
+        }
+        buf += digits((int32_t)value);
+        *buf = 0;
+        end = buf;
+        buf--;
+        do {
+            *buf = (value%10) + '0';
+            value /= 10;
+            buf--;
+        } while(value);
+        return end;
+    }
+}
+
+static uint64_t now()
+{
+#ifdef HAVE_RDTSC
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+//AVR cycle model (atmega32, avr-gcc -Os)
+#define AVR_DIVMODSI4   650     //__divmodsi4 call, 32 bit signed
+#define AVR_LPM32       12
+#define AVR_LPM16       8
+#define AVR_STEP32      8       //compare + subtract + digit++
+#define AVR_STEP16      5
+#define AVR_POWER       8       //loop overhead per power of ten
+
+static uint32_t avrOld(uint32_t v)
+{
+    return 2 * old::digits(v) * AVR_DIVMODSI4;
+}
+
+static uint32_t avrNew(uint32_t v)
+{
+    char buf[16];
+    uint32_t c = 0;
+    snprintf(buf, sizeof(buf), "%010u", (unsigned)v);
+    int first16 = 5;
+    if(v > UINT16_MAX) {
+        for(int i = 0; i < 6; i++)
+            c += AVR_POWER + AVR_LPM32 + (buf[i] - '0' + 1) * AVR_STEP32;
+        first16 = 6;
+    }
+    for(int i = first16; i < 9; i++)
+        c += AVR_POWER + AVR_LPM16 + (buf[i] - '0' + 1) * AVR_STEP16;
+    return c;
+}
+
+static volatile char sink;
+
+template<class F>
+static double run(F f, uint32_t step, uint32_t max)
+{
+    char buf[16];
+    uint32_t n = 0;
+    uint64_t start = now();
+    for(uint64_t v = 0; v < max; v += step, n++) {
+        f(v, buf);
+        sink = buf[0];
+    }
+    return double(now() - start) / n;
+}
+
+static int check()
+{
+    char a[16], b[16];
+    int errors = 0;
+    for(int64_t v = -100000; v < 2000000; v++) {
+        old::printLong(v, a);
+        PrintNumber::printLong(v, b);
+        if(strcmp(a, b) || old::digits(v) != (v < 0) + PrintNumber::digits(v < 0 ? -v : v)) {
+            if(errors++ < 10) printf("mismatch: %s %s\n", a, b);
+        }
+    }
+    const int32_t edge[] = {INT32_MAX, INT32_MIN + 1, 999999999, 1000000000, 65535, 65536, 99999, 100000};
+    for(unsigned i = 0; i < sizeof(edge)/sizeof(edge[0]); i++) {
+        old::printLong(edge[i], a);
+        PrintNumber::printLong(edge[i], b);
+        if(strcmp(a, b)) {
+            errors++;
+            printf("mismatch: %s %s\n", a, b);
+        }
+    }
+    PrintNumber::printFixed(5, 3, b);
+    if(strcmp(b, "0.005")) { errors++; printf("printFixed: %s\n", b); }
+    PrintNumber::printFixed(12345, 2, b);
+    if(strcmp(b, "123.45")) { errors++; printf("printFixed: %s\n", b); }
+    return errors;
+}
+
+int main()
+{
+    int errors = check();
+    printf("check: %s\n", errors ? "FAILED" : "ok");
+
+#ifdef HAVE_RDTSC
+    const char *unit = "cycles";
+#else
+    const char *unit = "ns";
+#endif
+    struct { const char *name; uint32_t step, max; } ranges[] = {
+        {"uint16 (ANALOG_* values)", 1, 65536},
+        {"uint32 (time, ETA)", 4099, 0xfffffff0},
+    };
+    for(unsigned i = 0; i < sizeof(ranges)/sizeof(ranges[0]); i++) {
+        double o = run([](uint32_t v, char *buf) { old::printLong(v, buf); }, ranges[i].step, ranges[i].max);
+        double n = run([](uint32_t v, char *buf) { PrintNumber::printUInt(v, buf); }, ranges[i].step, ranges[i].max);
+        printf("%-26s host old: %7.1f %s/value  new: %7.1f %s/value\n", ranges[i].name, o, unit, n, unit);
+        double ao = 0, an = 0;
+        uint32_t count = 0;
+        for(uint64_t v = 0; v < ranges[i].max; v += ranges[i].step, count++) {
+            ao += avrOld(v);
+            an += avrNew(v);
+        }
+        printf("%-26s AVR  old: %7.1f cycles/value  new: %7.1f cycles/value (model)\n", "", ao/count, an/count);
+    }
+    return errors != 0;
+}
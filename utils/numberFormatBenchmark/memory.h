@@ -0,0 +1,14 @@
+// host replacement of src/hardware/*/cpu/memory.h
+#ifndef MEMORY_H_
+#define MEMORY_H_
+
+#define PROGMEM
+
+namespace pgm {
+    template<class Type>
+    inline Type read(const Type * address) {
+        return *address;
+    }
+};
+
+#endif /* MEMORY_H_ */
@@ -0,0 +1,126 @@
+#!/usr/bin/python
+# -*- coding: utf-8 -*-
+#
+# Report for the main loop profiling zones (src/core/drivers/Profile.h).
+#
+# build the firmware with ENABLE_PROFILE (GlobalConfig.h), set "UART" to debug
+# or higher and capture the serial log, the zones are sent in channel 4:
+#
+#   $4;program;time;count;total;min;max;...;CRC     (times in microseconds,
+#                                                    since the previous line)
+# usage:
+#   profileReport.py log.txt                - summary of the whole log
+#   profileReport.py log.txt --every 10     - also a summary every 10 lines
+#   cat /dev/ttyUSB0 | profileReport.py -   - read from stdin
+
+from __future__ import print_function
+import sys
+import argparse
+
+# Profile::Zone
+ZONES = ['Strategy', 'Screen', 'SerialLog', 'AnalogInputs', 'Keyboard']
+CHANNEL = '4'
+
+
+class Zone(object):
+    def __init__(self, name):
+        self.name = name
+        self.count = 0
+        self.total = 0
+        self.min = None
+        self.max = 0
+
+    def add(self, count, total, tmin, tmax):
+        if count == 0:
+            return
+        self.count += count
+        self.total += total
+        self.min = tmin if self.min is None else min(self.min, tmin)
+        self.max = max(self.max, tmax)
+
+
+def check_crc(line):
+    # SerialLog::sendEnd: xor of all chars up to the last ';'
+    end = line.rfind(';')
+    if end < 0:
+        return False
+    crc = 0
+    for c in line[:end + 1]:
+        crc ^= ord(c)
+    try:
+        return crc == int(line[end + 1:])
+    except ValueError:
+        return False
+
+
+def parse(line):
+    # returns (time [s], [(count, total, min, max), ...]) or None
+    line = line.strip()
+    if not line.startswith('$' + CHANNEL + ';') or not check_crc(line):
+        return None
+    fields = line[1:].split(';')[:-1]
+    values = [int(x) for x in fields[3:]]
+    if len(values) != 4 * len(ZONES):
+        return None
+    stats = [tuple(values[i:i + 4]) for i in range(0, len(values), 4)]
+    return float(fields[2]), stats
+
+
+def report(zones, seconds, out):
+    print('%-14s %8s %12s %10s %10s %10s %7s' %
+          ('zone', 'count', 'total[ms]', 'mean[us]', 'min[us]', 'max[us]', 'load'), file=out)
+    for z in zones:
+        mean = z.total // z.count if z.count else 0
+        load = '%6.1f%%' % (100.0 * z.total / (seconds * 1e6)) if seconds > 0 else '      -'
+        print('%-14s %8d %12.1f %10d %10s %10d %7s' %
+              (z.name, z.count, z.total / 1000.0, mean,
+               '-' if z.min is None else z.min, z.max, load), file=out)
+    print('time: %.1fs' % seconds, file=out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='cheali-charger profiling report')
+    parser.add_argument('log', help='serial log file, "-" for stdin')
+    parser.add_argument('--every', type=int, default=0, help='print a summary every N lines')
+    args = parser.parse_args()
+
+    f = sys.stdin if args.log == '-' else open(args.log)
+    zones = [Zone(n) for n in ZONES]
+    part = [Zone(n) for n in ZONES]
+    first = last = part_start = None
+    lines = bad = 0
+
+    for line in f:
+        if not line.startswith('$' + CHANNEL + ';'):
+            continue
+        r = parse(line)
+        if r is None:
+            bad += 1
+            continue
+        t, stats = r
+        if first is None:
+            # the first line covers an unknown time span
+            first = part_start = last = t
+            continue
+        last = t
+        lines += 1
+        for z, p, s in zip(zones, part, stats):
+            z.add(*s)
+            p.add(*s)
+        if args.every and lines % args.every == 0:
+            report(part, t - part_start, sys.stdout)
+            print()
+            part = [Zone(n) for n in ZONES]
+            part_start = t
+
+    if first is None or lines == 0:
+        print('no channel %s lines found (ENABLE_PROFILE, UART >= debug?)' % CHANNEL, file=sys.stderr)
+        return 1
+    report(zones, last - first, sys.stdout)
+    if bad:
+        print('skipped %d corrupted lines' % bad, file=sys.stderr)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
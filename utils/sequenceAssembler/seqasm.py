@@ -0,0 +1,223 @@
+#!/usr/bin/python
+# -*- coding: utf-8 -*-
+#
+# Assembler for the program sequencer bytecode (src/core/Sequencer.h).
+#
+# example (overnight test of a 3S LiPo):
+#
+#   start:
+#       set Vd_per_cell 3.5V
+#       set Id 2A
+#       run discharge
+#       jlt Cout 1800mAh done   # jump if the pack delivered less (worn out)
+#       rest 30                 # max. minutes, ends when the voltage has relaxed
+#       set Ic 2.2A
+#       run charge
+#       run measureR
+#       loop start 3
+#   done:
+#       run storage
+#
+# usage:
+#   seqasm.py program.seq                   - print the bytecode
+#   seqasm.py program.seq -o program.bin    - write the raw bytecode
+#   seqasm.py program.seq --eeprom eeprom.bin --offset 992
+#                                           - patch an eeprom dump (+CRC),
+#                                             offset = offsetof(eeprom::Data, sequence)
+
+from __future__ import print_function
+import sys
+import re
+import argparse
+
+OP_RUN = 1
+OP_REST = 2
+OP_SET = 3
+OP_LOOP = 4
+OP_JUMP_IF_LESS = 5
+OP_END = 0xff
+MAX_LOOPS = 3   # SEQUENCER_MAX_LOOPS
+
+# Program::ProgramType
+PROGRAMS = ['charge', 'chargeBalance', 'balance', 'discharge', 'fastCharge',
+            'storage', 'storageBalance', 'dcCycle', 'capacityCheck', 'measureR']
+
+# ProgramData::Battery, 16 bit words
+BATTERY_FIELDS = ['type', 'capacity', 'cells', 'Ic', 'Id', 'Vc_per_cell', 'Vd_per_cell',
+                  'minIc', 'minId', 'time', 'enable_externT', 'externTCO',
+                  'enable_adaptiveDischarge', 'DCRestTime', 'capCutoff']
+# dischargeMode: 0 - current, 1 - power (dischargeValue in W), 2 - resistance (in Ohm)
+BATTERY_LIXX = ['Vs_per_cell', 'balancerError', 'dischargeMode', 'dischargeValue']
+BATTERY_NIXX = ['enable_deltaV', 'deltaV', 'deltaVIgnoreTime', 'deltaT', 'DCcycles']
+FIRST_SET_FIELD = BATTERY_FIELDS.index('Ic')
+
+
+def analog_inputs(cells):
+    # AnalogInputs::Name
+    names = ['Vout_plus_pin', 'Vout_minus_pin', 'Ismps', 'Idischarge',
+             'VoutMux', 'Tintern', 'Vin', 'Textern']
+    names += ['Vb%d_pin' % i for i in range(max(cells, 6) + 1)]
+    names += ['IsmpsSet', 'IdischargeSet',
+              'VirtualInputs', 'Vout', 'Vbalancer', 'VoutBalancer', 'VobInfo', 'VbalanceInfo',
+              'Iout', 'Pout', 'Cout', 'Eout',
+              'deltaVout', 'deltaVoutMax', 'deltaTextern', 'deltaLastCount']
+    names += ['Vb%d' % i for i in range(1, max(cells, 6) + 1)]
+    return names
+
+
+# value suffix -> factor to the firmware units (mV, mA, mAh, 0.01C, mOhm, 0.01W)
+UNITS = {'': 1, 'mV': 1, 'V': 1000, 'mA': 1, 'A': 1000, 'mAh': 1, 'Ah': 1000,
+         'C': 100, 'mOhm': 1, 'Ohm': 1000, 'W': 100, 'min': 1}
+
+
+class AsmError(Exception):
+    pass
+
+
+def parse_value(s, bits=16, signed=False):
+    m = re.match(r'^(-?[0-9]*\.?[0-9]+)([a-zA-Z]*)$', s)
+    if not m or m.group(2) not in UNITS:
+        raise AsmError('invalid value: ' + s)
+    v = int(round(float(m.group(1)) * UNITS[m.group(2)]))
+    lo = -(1 << (bits - 1)) if signed else 0
+    hi = (1 << bits) - 1
+    if v < lo or v > hi:
+        raise AsmError('value out of range: ' + s)
+    return v & hi
+
+
+def lookup(name, table, what):
+    for i, n in enumerate(table):
+        if n.lower() == name.lower():
+            return i
+    raise AsmError('unknown %s: %s' % (what, name))
+
+
+def word(v):
+    return [v & 0xff, (v >> 8) & 0xff]
+
+
+def assemble(lines, cells=6):
+    inputs = analog_inputs(cells)
+    fields = BATTERY_FIELDS + BATTERY_LIXX
+    fields_nixx = BATTERY_FIELDS + BATTERY_NIXX
+    labels = {}
+    code = []
+    fixups = []
+
+    for nr, line in enumerate(lines, 1):
+        line = line.split('#')[0].strip()
+        if not line:
+            continue
+        try:
+            m = re.match(r'^(\w+):\s*(.*)$', line)
+            if m:
+                labels[m.group(1)] = len(code)
+                line = m.group(2)
+                if not line:
+                    continue
+            args = line.split()
+            op = args[0].lower()
+            if op == 'run' and len(args) == 2:
+                code += [OP_RUN, lookup(args[1], PROGRAMS, 'program')]
+            elif op == 'rest' and len(args) == 2:
+                code += [OP_REST, parse_value(args[1], 8)]
+            elif op == 'set' and len(args) == 3:
+                try:
+                    f = lookup(args[1], fields, 'battery field')
+                except AsmError:
+                    f = lookup(args[1], fields_nixx, 'battery field')
+                if f < FIRST_SET_FIELD:
+                    raise AsmError('read only battery field: ' + args[1])
+                code += [OP_SET, f] + word(parse_value(args[2], signed=True))
+            elif op == 'loop' and len(args) == 3:
+                fixups.append((len(code) + 1, args[1], nr, True))
+                code += [OP_LOOP, 0, parse_value(args[2], 8)]
+            elif op == 'jlt' and len(args) == 4:
+                code += [OP_JUMP_IF_LESS, lookup(args[1], inputs, 'input')]
+                code += word(parse_value(args[2], signed=True))
+                fixups.append((len(code), args[3], nr, False))
+                code += [0]
+            elif op == 'end' and len(args) == 1:
+                code += [OP_END]
+            else:
+                raise AsmError('syntax error: ' + line)
+        except AsmError as e:
+            raise AsmError('line %d: %s' % (nr, e))
+
+    loops = []
+    for adr, label, nr, is_loop in fixups:
+        if label not in labels:
+            raise AsmError('line %d: unknown label: %s' % (nr, label))
+        code[adr] = labels[label]
+        if is_loop:
+            loops.append((labels[label], adr - 1, nr))
+
+    for start, end, nr in loops:
+        depth = len([1 for s, e, n in loops if s <= start and end <= e])
+        if depth > MAX_LOOPS:
+            raise AsmError('line %d: too many nested loops (max. %d)' % (nr, MAX_LOOPS))
+    return code
+
+
+def crc16(data):
+    # eeprom::crc16_update
+    crc = 0xffff
+    for a in data:
+        crc ^= a
+        for i in range(8):
+            if crc & 1:
+                crc = (crc >> 1) ^ 0xA001
+            else:
+                crc >>= 1
+    return crc
+
+
+def main():
+    parser = argparse.ArgumentParser(description='cheali-charger sequence assembler')
+    parser.add_argument('source')
+    parser.add_argument('-o', '--output', help='raw bytecode output file')
+    parser.add_argument('--size', type=int, default=30, help='SEQUENCER_PROGRAM_SIZE (default 30)')
+    parser.add_argument('--cells', type=int, default=6, help='MAX_BALANCE_CELLS (default 6)')
+    parser.add_argument('--eeprom', help='eeprom dump to patch')
+    parser.add_argument('--offset', type=int, help='offset of eeprom::Data::sequence')
+    args = parser.parse_args()
+
+    try:
+        with open(args.source) as f:
+            code = assemble(f.readlines(), args.cells)
+    except AsmError as e:
+        print('%s: %s' % (args.source, e), file=sys.stderr)
+        return 1
+
+    if len(code) > args.size:
+        print('%s: program too big: %d > %d bytes' % (args.source, len(code), args.size), file=sys.stderr)
+        return 1
+    print('size: %d/%d bytes' % (len(code), args.size))
+    code += [OP_END] * (args.size - len(code))
+    data = bytearray(code)
+    print('{' + ', '.join('0x%02x' % b for b in data) + '}')
+
+    if args.output:
+        with open(args.output, 'wb') as f:
+            f.write(data)
+
+    if args.eeprom:
+        if args.offset is None:
+            print('--offset is required with --eeprom', file=sys.stderr)
+            return 1
+        with open(args.eeprom, 'rb') as f:
+            eeprom = bytearray(f.read())
+        end = args.offset + args.size + 2
+        if end > len(eeprom):
+            eeprom += bytearray([0xff] * (end - len(eeprom)))
+        eeprom[args.offset:args.offset + args.size] = data
+        eeprom[args.offset + args.size:end] = bytearray(word(crc16(data)))
+        with open(args.eeprom, 'wb') as f:
+            f.write(eeprom)
+        print('%s: patched at %d, CRC 0x%04x' % (args.eeprom, args.offset, crc16(data)))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())